@@ -0,0 +1,804 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "otm/otm.hpp"
+
+namespace otm
+{
+	// Inputs are randomized and cycled through so that nothing is folded into a constant. Must be a power of 2
+	static constexpr size_t kInputs = 1024;
+	static constexpr size_t kBatch = 4096;
+
+	template <class T, size_t L>
+	static std::vector<Vector<T, L>> RandVecs(size_t n)
+	{
+		std::vector<Vector<T, L>> v(n);
+		for (auto& x : v) x = Vector<T, L>::Rand(-10, 10);
+		return v;
+	}
+
+	template <class T>
+	static std::vector<Matrix<T, 4>> RandMats(size_t n)
+	{
+		std::vector<Matrix<T, 4>> v(n);
+		for (auto& m : v) for (auto& r : m) r = Vector<T, 4>::Rand(-10, 10);
+		return v;
+	}
+
+	template <class T>
+	static Quaternion<T> RandQuat()
+	{
+		const Vector<T, 4> v = Vector<T, 4>::Rand(-1, 1);
+		Quaternion<T> q{v[0], v[1], v[2], v[3]};
+		return q / std::sqrt(q.LenSqr());
+	}
+
+	template <class T>
+	static std::vector<Quaternion<T>> RandQuats(size_t n)
+	{
+		std::vector<Quaternion<T>> v(n);
+		for (auto& q : v) q = RandQuat<T>();
+		return v;
+	}
+
+	// Throughput: independent operations on randomized inputs
+	template <class In, class Fn>
+	static void RunUnary(benchmark::State& state, const std::vector<In>& in, Fn fn)
+	{
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(fn(in[i]));
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <class A, class B, class Fn>
+	static void RunBinary(benchmark::State& state, const std::vector<A>& a, const std::vector<B>& b, Fn fn)
+	{
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(fn(a[i], b[i]));
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <class T>
+	static void BM_Vec3Add(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 3>(kInputs), b = RandVecs<T, 3>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x + y; });
+	}
+
+	template <class T>
+	static void BM_Vec3Dot(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 3>(kInputs), b = RandVecs<T, 3>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x | y; });
+	}
+
+	template <class T>
+	static void BM_Vec3Cross(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 3>(kInputs), b = RandVecs<T, 3>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x ^ y; });
+	}
+
+	template <class T>
+	static void BM_Vec3Normalize(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 3>(kInputs);
+		RunUnary(state, a, [](auto x) { x.Normalize(); return x; });
+	}
+
+	template <class T>
+	static void BM_Vec4Lerp(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 4>(kInputs), b = RandVecs<T, 4>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return Lerp(x, y, T(0.3)); });
+	}
+
+	template <class T>
+	static void BM_Mat4Mul(benchmark::State& state)
+	{
+		const auto a = RandMats<T>(kInputs), b = RandMats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x * y; });
+	}
+
+	// Latency: each multiplication depends on the previous result
+	template <class T>
+	static void BM_Mat4MulChain(benchmark::State& state)
+	{
+		// Products of rotations stay rotations, so values never grow into inf/NaN however long this runs
+		std::vector<Matrix<T, 4>> a(kInputs);
+		for (auto& x : a) x = MakeRotation<4>(RandQuat<T>());
+
+		auto m = Matrix<T, 4>::Identity();
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			m = m * a[i];
+			benchmark::DoNotOptimize(m);
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <class T>
+	static void BM_Mat4Det(benchmark::State& state)
+	{
+		const auto a = RandMats<T>(kInputs);
+		RunUnary(state, a, [](auto& x) { return x.Det(); });
+	}
+
+	template <class T>
+	static void BM_Mat4Inv(benchmark::State& state)
+	{
+		const auto a = RandMats<T>(kInputs);
+		RunUnary(state, a, [](auto& x) { return x.Inv(); });
+	}
+
+	template <class T>
+	static void BM_Vec4MulMat4(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 4>(kInputs);
+		const auto b = RandMats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x * y; });
+	}
+
+	template <class T>
+	static void BM_QuatMul(benchmark::State& state)
+	{
+		const auto a = RandQuats<T>(kInputs), b = RandQuats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x * y; });
+	}
+
+	template <class T>
+	static void BM_QuatRotate(benchmark::State& state)
+	{
+		const auto a = RandVecs<T, 3>(kInputs);
+		const auto b = RandQuats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& v, auto& q) { return v.RotatedByUnit(q); });
+	}
+
+	template <class T>
+	static void BM_QuatSlerp(benchmark::State& state)
+	{
+		const auto a = RandQuats<T>(kInputs), b = RandQuats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return Slerp(x, y, T(0.3)); });
+	}
+
+	template <class T>
+	static void BM_QuatSlerpFast(benchmark::State& state)
+	{
+		const auto a = RandQuats<T>(kInputs), b = RandQuats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return SlerpFast(x, y, T(0.3)); });
+	}
+
+	template <class T>
+	static void BM_QuatNlerp(benchmark::State& state)
+	{
+		const auto a = RandQuats<T>(kInputs), b = RandQuats<T>(kInputs);
+		RunBinary(state, a, b, [](auto& x, auto& y) { return Nlerp(x, y, T(0.3)); });
+	}
+
+	// Blend of two poses of one skeleton. Items are bones.
+	enum class BlendMode
+	{
+		kSlerp,
+		kSlerpFast,
+		kNlerpSoA,
+		kSlerpFastSoA
+	};
+
+	static void BM_PoseBlend(benchmark::State& state, BlendMode mode)
+	{
+		const auto bones = static_cast<size_t>(state.range(0));
+		const auto a = RandQuats<Float>(bones), b = RandQuats<Float>(bones);
+		std::vector<Quat> out(bones);
+
+		std::vector<Vec4> va(bones), vb(bones);
+		for (size_t i = 0; i < bones; ++i)
+		{
+			va[i] = {a[i].v[0], a[i].v[1], a[i].v[2], a[i].s};
+			vb[i] = {b[i].v[0], b[i].v[1], b[i].v[2], b[i].s};
+		}
+		const SoA<Vec4> sa{va.data(), bones}, sb{vb.data(), bones};
+		SoA<Vec4> sout{bones};
+
+		for (auto _ : state)
+		{
+			const auto alpha = 0.3_f;
+			switch (mode)
+			{
+			case BlendMode::kSlerp:
+				for (size_t i = 0; i < bones; ++i)
+					out[i] = Slerp(a[i], b[i], alpha);
+				break;
+			case BlendMode::kSlerpFast:
+				for (size_t i = 0; i < bones; ++i)
+					out[i] = SlerpFast(a[i], b[i], alpha);
+				break;
+			case BlendMode::kNlerpSoA:
+				Nlerp(sa, sb, alpha, sout);
+				break;
+			case BlendMode::kSlerpFastSoA:
+				SlerpFast(sa, sb, alpha, sout);
+				break;
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::DoNotOptimize(sout.Data(0));
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * bones);
+	}
+
+	// Local transforms to skinning matrices for one skeleton. Items are bones.
+	static void BM_PoseEval(benchmark::State& state, bool naive)
+	{
+		const auto bones = static_cast<size_t>(state.range(0));
+		std::vector<int32_t> parents(bones, kNoParent);
+		std::vector<Transform> local(bones);
+		for (size_t i = 0; i < bones; ++i)
+		{
+			if (i > 0)
+				parents[i] = static_cast<int32_t>(Rand<size_t>(0, i - 1));
+			local[i] = {Vec3::Rand(-1, 1), RandQuat<Float>(), Vec3::Rand(0.9f, 1.1f)};
+		}
+
+		std::vector<Mat4x3> inverse_bind(bones), model(bones), palette(bones);
+		InverseBindPoses(parents.data(), local.data(), inverse_bind.data(), bones);
+		std::vector<Mat4> inverse_bind4(bones), model4(bones), palette4(bones);
+		for (size_t i = 0; i < bones; ++i)
+			inverse_bind4[i] = Mat4::Identity(inverse_bind[i]);
+
+		for (auto _ : state)
+		{
+			if (naive)
+			{
+				for (size_t i = 0; i < bones; ++i)
+				{
+					const auto m = local[i].ToMatrix();
+					model4[i] = parents[i] == kNoParent ? m : m * model4[parents[i]];
+					palette4[i] = inverse_bind4[i] * model4[i];
+				}
+				benchmark::DoNotOptimize(palette4.data());
+			}
+			else
+			{
+				EvaluatePose(parents.data(), local.data(), inverse_bind.data(), model.data(), palette.data(), bones);
+				benchmark::DoNotOptimize(palette.data());
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * bones);
+	}
+
+	// Vertices skinned by 4 influences each out of a 300-bone palette. Items are vertices.
+	enum class SkinMode
+	{
+		kMatrix,
+		kDualQuat,
+		kDualQuatBatch
+	};
+
+	static void BM_Skinning(benchmark::State& state, SkinMode mode)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		constexpr size_t kBones = 300;
+
+		std::vector<DualQuat> palette(kBones);
+		std::vector<Mat4x3> matrices(kBones);
+		for (size_t b = 0; b < kBones; ++b)
+		{
+			const Transform t{Vec3::Rand(-1, 1), RandQuat<Float>()};
+			palette[b] = DualQuat{t};
+			matrices[b] = t.ToAffine();
+		}
+
+		std::vector<uint32_t> bones(n * 4);
+		std::vector<Float> weights(n * 4);
+		for (size_t i = 0; i < n * 4; ++i)
+		{
+			bones[i] = Rand<uint32_t>(0, kBones - 1);
+			weights[i] = 0.25f;
+		}
+		const auto in = RandVecs<Float, 3>(n);
+		std::vector<Vec3> out(n);
+
+		for (auto _ : state)
+		{
+			switch (mode)
+			{
+			case SkinMode::kMatrix:
+				for (size_t i = 0; i < n; ++i)
+				{
+					auto m = matrices[bones[i * 4]] * weights[i * 4];
+					for (size_t k = 1; k < 4; ++k)
+						m += matrices[bones[i * 4 + k]] * weights[i * 4 + k];
+					out[i] = TransformPoint(in[i], m);
+				}
+				break;
+			case SkinMode::kDualQuat:
+				for (size_t i = 0; i < n; ++i)
+					out[i] = Blend(palette.data(), &bones[i * 4], &weights[i * 4], 4).TransformPoint(in[i]);
+				break;
+			case SkinMode::kDualQuatBatch:
+				SkinPoints<4>(palette.data(), bones.data(), weights.data(), in.data(), out.data(), n);
+				break;
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+	}
+
+	// Random rotations so the branchy paths mispredict. Items are matrices.
+	static void BM_Decompose(benchmark::State& state, std::optional<Decomposition> batch)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		std::vector<Mat4> in(n);
+		for (auto& m : in)
+			m = Transform{Vec3::Rand(-10, 10), RandQuat<Float>(), Vec3::Rand(0.5f, 2)}.ToMatrix();
+		std::vector<Transform> out(n);
+
+		for (auto _ : state)
+		{
+			if (batch)
+			{
+				DecomposeTransforms(in.data(), out.data(), n, *batch);
+			}
+			else
+			{
+				for (size_t i = 0; i < n; ++i)
+					out[i] = Transform{in[i]};
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+	}
+
+	static void BM_TransformCompose(benchmark::State& state)
+	{
+		std::vector<Transform> a(kInputs), b(kInputs);
+		for (size_t i = 0; i < kInputs; ++i)
+		{
+			a[i] = {Vec3::Rand(-10, 10), RandQuat<Float>(), Vec3{All{}, Rand<Float>(0.5, 2)}};
+			b[i] = {Vec3::Rand(-10, 10), RandQuat<Float>(), Vec3{All{}, Rand<Float>(0.5, 2)}};
+		}
+		RunBinary(state, a, b, [](auto& x, auto& y) { return x * y; });
+	}
+
+	static void BM_TransformPoint(benchmark::State& state)
+	{
+		const auto a = RandVecs<Float, 3>(kInputs);
+		std::vector<Transform> b(kInputs);
+		for (auto& t : b) t = {Vec3::Rand(-10, 10), RandQuat<Float>(), Vec3::Rand(0.5, 2)};
+		RunBinary(state, a, b, [](auto& p, auto& t) { return t.TransformPoint(p); });
+	}
+
+	// Batch APIs: items are vectors, bytes are input plus output
+
+	template <class T, class Fn>
+	static void RunBatch(benchmark::State& state, Fn fn)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		const auto in = RandVecs<T, 3>(n);
+		std::vector<Vector<T, 3>> out(n);
+		for (auto _ : state)
+		{
+			fn(in.data(), out.data(), n);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+		state.SetBytesProcessed(state.iterations() * n * 2 * sizeof(Vector<T, 3>));
+	}
+
+	template <class T>
+	static void BM_TransformPoints(benchmark::State& state)
+	{
+		const auto m = RandMats<T>(1)[0];
+		RunBatch<T>(state, [&](auto* in, auto* out, size_t n) { TransformPoints(in, out, n, m); });
+	}
+
+	template <class T>
+	static void BM_TransformPointsLoop(benchmark::State& state)
+	{
+		const auto m = RandMats<T>(1)[0];
+		RunBatch<T>(state, [&](auto* in, auto* out, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) out[i] = TransformPoint(in[i], m);
+		});
+	}
+
+	template <class T>
+	static void BM_RotateVectors(benchmark::State& state)
+	{
+		const auto q = RandQuat<T>();
+		RunBatch<T>(state, [&](auto* in, auto* out, size_t n) { RotateVectors(in, out, n, q); });
+	}
+
+	template <class T>
+	static void BM_SoANormalize(benchmark::State& state)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		const auto in = RandVecs<T, 3>(n);
+		const SoA<Vector<T, 3>> src{in.data(), n};
+		SoA<Vector<T, 3>> soa{n};
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			soa = src;
+			state.ResumeTiming();
+			soa.Normalize();
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+	}
+
+	static Frustum MakeBenchFrustum()
+	{
+		const auto view = MakeLookAt(Vec3{0, 0, -100}, *Vec3{0, 0, 1}.Unit(), *Vec3{0, 1, 0}.Unit());
+		return Frustum::FromViewProj(*view * MakePerspective(Vec2{16, 9}, Float(1), Float(1000), 60_deg));
+	}
+
+	static void BM_CullSpheres(benchmark::State& state)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		SoA<Vec4> spheres{n};
+		for (size_t i = 0; i < n; ++i) spheres.Set(i, {Vec3::Rand(-500, 500), Rand<Float>(0, 10)});
+		const auto f = MakeBenchFrustum();
+		std::vector<uint64_t> visible((n + 63) / 64);
+		for (auto _ : state)
+		{
+			Cull(f, spheres, visible.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+	}
+
+	static void BM_CullAABBs(benchmark::State& state)
+	{
+		const auto n = static_cast<size_t>(state.range(0));
+		SoA<Vec3> mins{n}, maxs{n};
+		for (size_t i = 0; i < n; ++i)
+		{
+			const auto p = Vec3::Rand(-500, 500);
+			mins.Set(i, p);
+			maxs.Set(i, p + Vec3::Rand(0, 20));
+		}
+		const auto f = MakeBenchFrustum();
+		std::vector<uint64_t> visible((n + 63) / 64);
+		for (auto _ : state)
+		{
+			Cull(f, mins, maxs, visible.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * n);
+	}
+
+	static std::vector<AABB> RandBoxes(size_t n)
+	{
+		std::vector<AABB> boxes(n);
+		for (auto& b : boxes)
+		{
+			b.min = Vec3::Rand(-500, 500);
+			b.max = b.min + Vec3::Rand(0, 5);
+		}
+		return boxes;
+	}
+
+	static void BM_BVHBuild(benchmark::State& state)
+	{
+		const auto boxes = RandBoxes(static_cast<size_t>(state.range(0)));
+		BVH bvh;
+		for (auto _ : state)
+		{
+			bvh.Build(boxes.data(), boxes.size());
+			benchmark::DoNotOptimize(bvh.Nodes().data());
+		}
+		state.SetItemsProcessed(state.iterations() * boxes.size());
+	}
+
+	static void BM_BVHQuerySphere(benchmark::State& state)
+	{
+		const auto boxes = RandBoxes(static_cast<size_t>(state.range(0)));
+		const BVH bvh{boxes.data(), boxes.size()};
+		const auto centers = RandVecs<Float, 3>(kInputs);
+		size_t i = 0, found = 0;
+		for (auto _ : state)
+		{
+			bvh.Query(Sphere{centers[i], 10}, [&](uint32_t) { ++found; });
+			i = (i + 1) & (kInputs - 1);
+		}
+		benchmark::DoNotOptimize(found);
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	static void BM_BVHRaycast(benchmark::State& state)
+	{
+		const auto boxes = RandBoxes(static_cast<size_t>(state.range(0)));
+		const BVH bvh{boxes.data(), boxes.size()};
+		std::vector<Ray> rays(kInputs);
+		for (auto& r : rays) r = {Vec3::Rand(-500, 500), Vec3::Rand(-1, 1)};
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			const auto& ray = rays[i];
+			benchmark::DoNotOptimize(bvh.Raycast(ray, [&](uint32_t k, Float max_t) { return Raycast(ray, boxes[k], max_t); }));
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	static std::vector<Vec3> RandAgents(size_t n)
+	{
+		// Crowd spread over a plane, a few neighbours each within radius 1
+		std::vector<Vec3> p(n);
+		for (auto& x : p) x = Vec3{Rand<Float>(-200, 200), Rand<Float>(-1, 1), Rand<Float>(-200, 200)};
+		return p;
+	}
+
+	static void BM_HashGridBuild(benchmark::State& state)
+	{
+		const auto agents = RandAgents(static_cast<size_t>(state.range(0)));
+		HashGrid grid{2};
+		for (auto _ : state)
+		{
+			grid.Build(agents.data(), agents.size());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * agents.size());
+	}
+
+	static void BM_HashGridPairs(benchmark::State& state)
+	{
+		const auto agents = RandAgents(static_cast<size_t>(state.range(0)));
+		HashGrid grid{2};
+		grid.Build(agents.data(), agents.size());
+		size_t pairs = 0;
+		for (auto _ : state)
+			grid.QueryPairs(1, [&](uint32_t, uint32_t) { ++pairs; });
+		benchmark::DoNotOptimize(pairs);
+		state.SetItemsProcessed(state.iterations() * agents.size());
+	}
+
+	static void BM_HashGridMove(benchmark::State& state)
+	{
+		auto agents = RandAgents(static_cast<size_t>(state.range(0)));
+		const auto steps = RandVecs<Float, 3>(kInputs);
+		HashGrid grid{2};
+		grid.Build(agents.data(), agents.size());
+		for (auto _ : state)
+		{
+			for (uint32_t i = 0; i < agents.size(); ++i)
+			{
+				agents[i] += steps[i & (kInputs - 1)] * Float(0.01);
+				grid.Move(i, agents[i]);
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * agents.size());
+	}
+
+	static void BM_SweepAndPrune(benchmark::State& state)
+	{
+		auto boxes = RandBoxes(static_cast<size_t>(state.range(0)));
+		const auto steps = RandVecs<Float, 3>(kInputs);
+		SweepAndPrune sap;
+		sap.Update(boxes.data(), boxes.size());
+		for (auto _ : state)
+		{
+			// Small coherent motion every frame
+			for (size_t i = 0; i < boxes.size(); ++i)
+			{
+				const auto d = steps[i & (kInputs - 1)] * Float(0.01);
+				boxes[i].min += d;
+				boxes[i].max += d;
+			}
+			sap.Update(boxes.data(), boxes.size());
+			benchmark::DoNotOptimize(sap.Pairs().data());
+		}
+		state.SetItemsProcessed(state.iterations() * boxes.size());
+	}
+
+	template <class Target>
+	static void BM_TimeOfImpact(benchmark::State& state, const Target& target)
+	{
+		const auto from = RandVecs<Float, 3>(kInputs), motion = RandVecs<Float, 3>(kInputs);
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(TimeOfImpact(Sphere{from[i], 0.5f}, motion[i], target));
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Pairs of boxes, mostly close enough to take several iterations. Warm starts from the pair's simplex of the last run.
+	static void BM_Gjk(benchmark::State& state)
+	{
+		const bool warm = state.range(0);
+		std::vector<std::pair<OBB, OBB>> pairs(kInputs);
+		for (auto& [a, b] : pairs)
+		{
+			a = OBB::FromRotation(Vec3::Rand(-1, 1), RandQuat<Float>(), Vec3::Rand(0.5f, 1.5f));
+			b = OBB::FromRotation(Vec3::Rand(-3, 3), RandQuat<Float>(), Vec3::Rand(0.5f, 1.5f));
+		}
+
+		std::vector<GjkSimplex> simplices(kInputs);
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(Gjk(pairs[i].first, pairs[i].second, warm ? &simplices[i] : nullptr));
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Fits over one point cloud, laid out as an array or as SoA
+	template <class Fit>
+	static void BM_BoundsFit(benchmark::State& state, Fit fit)
+	{
+		const auto points = RandVecs<Float, 3>(static_cast<size_t>(state.range(0)));
+		const SoA<Vec3> soa{points.data(), points.size()};
+		for (auto _ : state)
+			benchmark::DoNotOptimize(fit(points, soa));
+		state.SetItemsProcessed(state.iterations() * points.size());
+	}
+
+	static std::vector<Triangle> RandTriangles(size_t n)
+	{
+		std::vector<Triangle> tris(n);
+		for (auto& t : tris)
+		{
+			const auto c = Vec3::Rand(-10, 10);
+			t = {c + Vec3::Rand(-1, 1), c + Vec3::Rand(-1, 1), c + Vec3::Rand(-1, 1)};
+		}
+		return tris;
+	}
+
+	// Items are ray-triangle tests. Coherent rays: nearby origins, similar directions.
+	enum class RaycastMode
+	{
+		kScalar,
+		kSoA,
+		kPacket
+	};
+
+	static void BM_RaycastTriangles(benchmark::State& state, RaycastMode mode)
+	{
+		const auto tris = RandTriangles(1024);
+		const SoA<Triangle> soa{tris.data(), tris.size()};
+
+		std::vector<Ray> rays(kInputs);
+		for (auto& r : rays)
+			r = {Vec3{-20, 0, 0} + Vec3::Rand(-1, 1), Vec3{1, 0, 0} + Vec3::Rand(-0.2f, 0.2f)};
+
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			if (mode == RaycastMode::kScalar)
+			{
+				for (size_t k = 0; k < RayPacket::size; ++k)
+				{
+					Float nearest = kInf;
+					for (const auto& t : tris)
+						if (const auto hit = Raycast(rays[i + k], t, nearest))
+							nearest = *hit;
+					benchmark::DoNotOptimize(nearest);
+				}
+			}
+			else if (mode == RaycastMode::kSoA)
+			{
+				for (size_t k = 0; k < RayPacket::size; ++k)
+					benchmark::DoNotOptimize(Raycast(rays[i + k], soa));
+			}
+			else
+			{
+				PacketHits hits;
+				Raycast(RayPacket{&rays[i], RayPacket::size}, tris.data(), tris.size(), hits);
+				benchmark::DoNotOptimize(hits);
+			}
+			i = (i + RayPacket::size) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations() * RayPacket::size * tris.size());
+	}
+
+	// Items are point-triangle distances: one query point against every triangle
+	static void BM_TriangleDist(benchmark::State& state, bool batched)
+	{
+		const auto tris = RandTriangles(1024);
+		const SoA<Triangle> soa{tris.data(), tris.size()};
+		const auto points = RandVecs<Float, 3>(kInputs);
+		std::vector<Float> out(tris.size());
+
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			if (batched)
+			{
+				DistSqr(soa, points[i], out.data());
+			}
+			else
+			{
+				for (size_t k = 0; k < tris.size(); ++k)
+					out[k] = DistSqr(tris[k], points[i]);
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+			i = (i + 1) & (kInputs - 1);
+		}
+		state.SetItemsProcessed(state.iterations() * tris.size());
+	}
+
+#define OTM_BENCH(name) \
+	BENCHMARK_TEMPLATE(name, float); \
+	BENCHMARK_TEMPLATE(name, double)
+
+#define OTM_BENCH_BATCH(name) \
+	BENCHMARK_TEMPLATE(name, float)->Arg(kBatch)->Arg(1 << 20); \
+	BENCHMARK_TEMPLATE(name, double)->Arg(kBatch)->Arg(1 << 20)
+
+	OTM_BENCH(BM_Vec3Add);
+	OTM_BENCH(BM_Vec3Dot);
+	OTM_BENCH(BM_Vec3Cross);
+	OTM_BENCH(BM_Vec3Normalize);
+	OTM_BENCH(BM_Vec4Lerp);
+	OTM_BENCH(BM_Mat4Mul);
+	OTM_BENCH(BM_Mat4MulChain);
+	OTM_BENCH(BM_Mat4Det);
+	OTM_BENCH(BM_Mat4Inv);
+	OTM_BENCH(BM_Vec4MulMat4);
+	OTM_BENCH(BM_QuatMul);
+	OTM_BENCH(BM_QuatRotate);
+	OTM_BENCH(BM_QuatSlerp);
+	OTM_BENCH(BM_QuatSlerpFast);
+	OTM_BENCH(BM_QuatNlerp);
+	BENCHMARK_CAPTURE(BM_PoseBlend, Slerp, BlendMode::kSlerp)->Arg(300);
+	BENCHMARK_CAPTURE(BM_PoseBlend, SlerpFast, BlendMode::kSlerpFast)->Arg(300);
+	BENCHMARK_CAPTURE(BM_PoseBlend, NlerpSoA, BlendMode::kNlerpSoA)->Arg(300);
+	BENCHMARK_CAPTURE(BM_PoseBlend, SlerpFastSoA, BlendMode::kSlerpFastSoA)->Arg(300);
+	BENCHMARK_CAPTURE(BM_PoseEval, Mat4, true)->Arg(300);
+	BENCHMARK_CAPTURE(BM_PoseEval, Affine, false)->Arg(300);
+	BENCHMARK_CAPTURE(BM_Skinning, Matrix, SkinMode::kMatrix)->Arg(10'000);
+	BENCHMARK_CAPTURE(BM_Skinning, DualQuat, SkinMode::kDualQuat)->Arg(10'000);
+	BENCHMARK_CAPTURE(BM_Skinning, DualQuatBatch, SkinMode::kDualQuatBatch)->Arg(10'000);
+	BENCHMARK_CAPTURE(BM_Decompose, Single, std::nullopt)->Arg(10'000);
+	BENCHMARK_CAPTURE(BM_Decompose, Batch, Decomposition::kNoShear)->Arg(10'000);
+	BENCHMARK_CAPTURE(BM_Decompose, BatchPolar, Decomposition::kPolar)->Arg(10'000);
+	BENCHMARK(BM_TransformCompose);
+	BENCHMARK(BM_TransformPoint);
+	OTM_BENCH_BATCH(BM_TransformPoints);
+	OTM_BENCH_BATCH(BM_TransformPointsLoop);
+	OTM_BENCH_BATCH(BM_RotateVectors);
+	OTM_BENCH_BATCH(BM_SoANormalize);
+	BENCHMARK(BM_CullSpheres)->Arg(200'000);
+	BENCHMARK(BM_CullAABBs)->Arg(200'000);
+	BENCHMARK(BM_BVHBuild)->Arg(50'000);
+	BENCHMARK(BM_BVHQuerySphere)->Arg(50'000);
+	BENCHMARK(BM_BVHRaycast)->Arg(50'000);
+	BENCHMARK(BM_HashGridBuild)->Arg(100'000);
+	BENCHMARK(BM_HashGridPairs)->Arg(100'000);
+	BENCHMARK(BM_HashGridMove)->Arg(100'000);
+	BENCHMARK(BM_SweepAndPrune)->Arg(50'000);
+	BENCHMARK_CAPTURE(BM_TimeOfImpact, AABB, AABB{Vec3{All{}, -2}, Vec3{All{}, 2}});
+	BENCHMARK_CAPTURE(BM_TimeOfImpact, Triangle, Triangle{Vec3{-3, -2, 0}, Vec3{3, -1, 1}, Vec3{0, 3, -1}});
+	BENCHMARK(BM_Gjk)->Arg(0)->Arg(1);
+	BENCHMARK_CAPTURE(BM_RaycastTriangles, Scalar, RaycastMode::kScalar);
+	BENCHMARK_CAPTURE(BM_RaycastTriangles, SoA, RaycastMode::kSoA);
+	BENCHMARK_CAPTURE(BM_RaycastTriangles, Packet, RaycastMode::kPacket);
+	BENCHMARK_CAPTURE(BM_TriangleDist, Scalar, false);
+	BENCHMARK_CAPTURE(BM_TriangleDist, SoA, true);
+	BENCHMARK_CAPTURE(BM_BoundsFit, AABB, [](auto& p, auto&) { return Bounds(p.data(), p.size()); })->Arg(1 << 20);
+	BENCHMARK_CAPTURE(BM_BoundsFit, AABBSoA, [](auto&, auto& soa) { return Bounds(soa); })->Arg(1 << 20);
+	BENCHMARK_CAPTURE(BM_BoundsFit, Ritter, [](auto& p, auto&) { return BoundingSphere(p.data(), p.size()); })->Arg(1 << 20);
+	BENCHMARK_CAPTURE(BM_BoundsFit, RitterSoA, [](auto&, auto& soa) { return BoundingSphere(soa); })->Arg(1 << 20);
+	BENCHMARK_CAPTURE(BM_BoundsFit, Welzl, [](auto& p, auto&) { return MinBoundingSphere(p.data(), p.size()); })->Arg(1 << 20);
+	BENCHMARK_CAPTURE(BM_BoundsFit, PCA, [](auto& p, auto&) { return BoundingOBB(p.data(), p.size()); })->Arg(1 << 20);
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,381 @@
+#pragma once
+#include "Geometry.hpp"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace otm
+{
+/**
+ * \brief Bounding volume hierarchy over AABBs, built with binned SAH.
+ * Nodes are stored depth-first in a flat array: left child immediately follows its parent.
+ * Items are referred to by their index in the array passed to Build().
+ */
+class BVH
+{
+public:
+    struct Node
+    {
+        AABB bounds;
+        uint32_t first; // Leaf: index into the item order. Inner: index of the right child
+        uint32_t count; // Number of items. 0 for inner nodes
+
+        [[nodiscard]] bool IsLeaf() const noexcept
+        {
+            return count != 0;
+        }
+    };
+
+    struct Hit
+    {
+        uint32_t index;
+        Float t;
+    };
+
+    static constexpr size_t kMaxDepth = 64;
+
+    BVH() noexcept = default;
+
+    BVH(const AABB* boxes, size_t count, size_t max_leaf_size = 4)
+    {
+        Build(boxes, count, max_leaf_size);
+    }
+
+    /**
+     * \brief Build hierarchy from scratch
+     * \param max_leaf_size Maximum number of items per leaf. Must be at least 1
+     */
+    void Build(const AABB* boxes, size_t count, size_t max_leaf_size = 4)
+    {
+        assert(max_leaf_size >= 1);
+        max_leaf_size_ = max_leaf_size;
+
+        nodes_.clear();
+        nodes_.reserve(count * 2);
+        order_.resize(count);
+        std::iota(order_.begin(), order_.end(), uint32_t{0});
+
+        std::vector<Vec3> centroids(count);
+        for (size_t i = 0; i < count; ++i)
+            centroids[i] = boxes[i].Center();
+
+        if (count > 0)
+            BuildNode(boxes, centroids.data(), 0, static_cast<uint32_t>(count), 0);
+
+        items_.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            items_[i] = boxes[order_[i]];
+    }
+
+    void Build(const Sphere* spheres, size_t count, size_t max_leaf_size = 4)
+    {
+        Build(ToBounds(spheres, count).data(), count, max_leaf_size);
+    }
+
+    /**
+     * \brief Update bounds of all nodes without changing the topology. Quality degrades as items move away from
+     * where they were at Build(); rebuild once queries get slow.
+     * \param boxes New bounds of items, in the same order and count as passed to Build()
+     */
+    void Refit(const AABB* boxes) noexcept
+    {
+        for (size_t i = 0; i < order_.size(); ++i)
+            items_[i] = boxes[order_[i]];
+        RefitNodes();
+    }
+
+    void Refit(const Sphere* spheres) noexcept
+    {
+        for (size_t i = 0; i < order_.size(); ++i)
+            items_[i] = Bounds(spheres[order_[i]]);
+        RefitNodes();
+    }
+
+    /**
+     * \brief Find the closest hit, nearer children first
+     * \param test Called as test(index, max_t) for items whose bounds the ray hits. Returns std::optional<Float>
+     * distance to the item, or nullopt if missed.
+     * \return Closest hit within [0, max_t] or nullopt
+     */
+    template <class Fn>
+    [[nodiscard]] std::optional<Hit> Raycast(const Ray& ray, Fn&& test, Float max_t = kInf) const
+    {
+        std::optional<Hit> hit;
+        if (nodes_.empty())
+            return hit;
+
+        const auto inv_dir = ray.InvDir();
+        const auto root_t = otm::Raycast(ray, inv_dir, nodes_[0].bounds, max_t);
+        if (!root_t)
+            return hit;
+
+        struct Entry
+        {
+            uint32_t node;
+            Float t;
+        };
+
+        Entry stack[kMaxDepth];
+        size_t top = 0;
+        stack[top++] = {0, *root_t};
+
+        while (top > 0)
+        {
+            const auto [index, entry_t] = stack[--top];
+            if (entry_t > max_t)
+                continue;
+
+            const auto& node = nodes_[index];
+            if (node.IsLeaf())
+            {
+                for (auto k = node.first; k < node.first + node.count; ++k)
+                {
+                    if (!otm::Raycast(ray, inv_dir, items_[k], max_t))
+                        continue;
+
+                    if (const std::optional<Float> t = test(order_[k], max_t); t && *t <= max_t)
+                    {
+                        max_t = *t;
+                        hit = Hit{order_[k], *t};
+                    }
+                }
+                continue;
+            }
+
+            const auto left = index + 1, right = node.first;
+            const auto tl = otm::Raycast(ray, inv_dir, nodes_[left].bounds, max_t);
+            const auto tr = otm::Raycast(ray, inv_dir, nodes_[right].bounds, max_t);
+
+            // Push the farther one first so the nearer one is visited first
+            if (tl && tr)
+            {
+                const auto near_first = *tl <= *tr;
+                stack[top++] = near_first ? Entry{right, *tr} : Entry{left, *tl};
+                stack[top++] = near_first ? Entry{left, *tl} : Entry{right, *tr};
+            }
+            else if (tl)
+            {
+                stack[top++] = {left, *tl};
+            }
+            else if (tr)
+            {
+                stack[top++] = {right, *tr};
+            }
+        }
+
+        return hit;
+    }
+
+    /**
+     * \brief Call fn(index) for each item whose bounds overlap the box
+     */
+    template <class Fn>
+    void Query(const AABB& box, Fn&& fn) const
+    {
+        Traverse([&](const AABB& b) { return IsOverlapped(box, b); }, fn);
+    }
+
+    /**
+     * \brief Call fn(index) for each item whose bounds overlap the sphere
+     */
+    template <class Fn>
+    void Query(const Sphere& sphere, Fn&& fn) const
+    {
+        Traverse([&](const AABB& b) { return IsOverlapped(sphere, b); }, fn);
+    }
+
+    /**
+     * \brief Call fn(index) for each item whose bounds are at least partially inside the frustum
+     */
+    template <class Fn>
+    void Query(const Frustum& frustum, Fn&& fn) const
+    {
+        Traverse([&](const AABB& b) { return IsOverlapped(frustum, b); }, fn);
+    }
+
+    [[nodiscard]] const std::vector<Node>& Nodes() const noexcept
+    {
+        return nodes_;
+    }
+
+    /**
+     * \brief Number of items
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return order_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return order_.empty();
+    }
+
+private:
+    static constexpr size_t kBins = 16;
+
+    static std::vector<AABB> ToBounds(const Sphere* spheres, size_t count)
+    {
+        std::vector<AABB> boxes(count);
+        for (size_t i = 0; i < count; ++i)
+            boxes[i] = Bounds(spheres[i]);
+        return boxes;
+    }
+
+    void RefitNodes() noexcept
+    {
+        // Children always come after their parent
+        for (size_t i = nodes_.size(); i-- > 0;)
+        {
+            auto& node = nodes_[i];
+            if (node.IsLeaf())
+            {
+                node.bounds = AABB::Empty();
+                for (auto k = node.first; k < node.first + node.count; ++k)
+                    node.bounds.Merge(items_[k]);
+            }
+            else
+            {
+                node.bounds = nodes_[i + 1].bounds;
+                node.bounds.Merge(nodes_[node.first].bounds);
+            }
+        }
+    }
+
+    uint32_t BuildNode(const AABB* boxes, const Vec3* centroids, uint32_t begin, uint32_t end, size_t depth)
+    {
+        const auto index = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back({});
+
+        auto bounds = AABB::Empty(), centroid_bounds = AABB::Empty();
+        for (auto i = begin; i < end; ++i)
+        {
+            bounds.Merge(boxes[order_[i]]);
+            centroid_bounds.Merge(centroids[order_[i]]);
+        }
+
+        const auto count = end - begin;
+        if (count <= max_leaf_size_)
+        {
+            nodes_[index] = {bounds, begin, count};
+            return index;
+        }
+
+        // Split along the longest axis of centroids
+        const auto size = centroid_bounds.Size();
+        const size_t axis = size[0] > size[1] ? (size[0] > size[2] ? 0 : 2) : (size[1] > size[2] ? 1 : 2);
+
+        // Beyond half the maximum depth, median splits keep the rest of the tree within the traversal stack
+        auto mid = begin;
+        if (size[axis] > 0 && depth < kMaxDepth / 2)
+            mid = SplitSAH(boxes, centroids, begin, end, axis, centroid_bounds.min[axis], size[axis]);
+
+        // Median split if SAH put everything on one side, e.g. when centroids coincide
+        if (mid == begin || mid == end)
+        {
+            mid = begin + count / 2;
+            std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                             [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+
+        BuildNode(boxes, centroids, begin, mid, depth + 1);
+        const auto right = BuildNode(boxes, centroids, mid, end, depth + 1);
+        nodes_[index] = {bounds, right, 0};
+        return index;
+    }
+
+    /**
+     * \brief Partition items by the split plane of least surface area cost
+     * \return Index of first item of right side
+     */
+    uint32_t SplitSAH(const AABB* boxes, const Vec3* centroids, uint32_t begin, uint32_t end, size_t axis,
+                      Float min, Float extent)
+    {
+        struct Bin
+        {
+            AABB bounds = AABB::Empty();
+            uint32_t count = 0;
+        };
+
+        Bin bins[kBins];
+        const auto scale = kBins / extent;
+        const auto BinOf = [&](uint32_t item)
+        {
+            return Min(static_cast<size_t>((centroids[item][axis] - min) * scale), kBins - 1);
+        };
+
+        for (auto i = begin; i < end; ++i)
+        {
+            auto& bin = bins[BinOf(order_[i])];
+            bin.bounds.Merge(boxes[order_[i]]);
+            ++bin.count;
+        }
+
+        // Cost of splitting after bin i = area(left) * count(left) + area(right) * count(right)
+        Float right_cost[kBins - 1];
+        auto acc = AABB::Empty();
+        uint32_t acc_count = 0;
+        for (size_t i = kBins - 1; i > 0; --i)
+        {
+            acc.Merge(bins[i].bounds);
+            acc_count += bins[i].count;
+            right_cost[i - 1] = acc_count ? acc.SurfaceArea() * acc_count : 0;
+        }
+
+        size_t best = 0;
+        auto best_cost = kInf;
+        acc = AABB::Empty();
+        acc_count = 0;
+        for (size_t i = 0; i < kBins - 1; ++i)
+        {
+            acc.Merge(bins[i].bounds);
+            acc_count += bins[i].count;
+            const auto cost = (acc_count ? acc.SurfaceArea() * acc_count : 0) + right_cost[i];
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best = i;
+            }
+        }
+
+        const auto mid = std::partition(order_.begin() + begin, order_.begin() + end,
+                                        [&](uint32_t item) { return BinOf(item) <= best; });
+        return static_cast<uint32_t>(mid - order_.begin());
+    }
+
+    template <class Overlap, class Fn>
+    void Traverse(Overlap&& overlaps, Fn&& fn) const
+    {
+        if (nodes_.empty())
+            return;
+
+        uint32_t stack[kMaxDepth];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0)
+        {
+            const auto& node = nodes_[stack[--top]];
+            if (!overlaps(node.bounds))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                for (auto k = node.first; k < node.first + node.count; ++k)
+                    if (overlaps(items_[k]))
+                        fn(order_[k]);
+            }
+            else
+            {
+                stack[top++] = node.first;
+                stack[top++] = static_cast<uint32_t>(&node - nodes_.data()) + 1;
+            }
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> order_; // Item indices in leaf order
+    std::vector<AABB> items_; // Item bounds in leaf order
+    size_t max_leaf_size_ = 4;
+};
+}
@@ -1,6 +1,8 @@
 #pragma once
-#include "otmfwd.hpp"
+#include "Simd.hpp"
+#include <limits>
 #include <random>
+#include <stdexcept>
 
 namespace otm
 {
@@ -10,6 +12,9 @@ constexpr auto kPi = kPiV<Float>;
 template <class T> constexpr auto kSmallNumV = static_cast<T>(1e-5);
 constexpr auto kSmallNum = kSmallNumV<Float>;
 
+template <class T> constexpr auto kInfV = std::numeric_limits<T>::infinity();
+constexpr auto kInf = kInfV<Float>;
+
 inline thread_local std::default_random_engine random_engine{std::random_device{}()};
 
 /**
@@ -115,14 +120,14 @@ template <class T1 = Float, class T2 = T1, class T = std::common_type_t<T1, T2>>
     return Distribution{T(min), T(max)}(random_engine);
 }
 
-template <class T, class U>[[nodiscard]] CommonFloat<T, U> Gauss(T mean, U stddev) noexcept
+template <class T, class... Ts>[[nodiscard]] constexpr CommonFloat<T, Ts...> ToFloat(T x) noexcept
 {
-    return std::normal_distribution<CommonFloat<T, U>>{ToFloat<U>(mean), ToFloat<T>(stddev)}(random_engine);
+    return static_cast<CommonFloat<T, Ts...>>(x);
 }
 
-template <class T, class... Ts>[[nodiscard]] constexpr CommonFloat<T, Ts...> ToFloat(T x) noexcept
+template <class T, class U>[[nodiscard]] CommonFloat<T, U> Gauss(T mean, U stddev) noexcept
 {
-    return static_cast<CommonFloat<T, Ts...>>(x);
+    return std::normal_distribution<CommonFloat<T, U>>{ToFloat<U>(mean), ToFloat<T>(stddev)}(random_engine);
 }
 
 template <class T1, class T2>[[nodiscard]] constexpr auto Min(T1 a, T2 b) noexcept
@@ -144,6 +149,15 @@ template <class T, size_t L>[[nodiscard]] constexpr T Min(const Vector<T, L>& v)
     return m;
 }
 
+// Component-wise minimum
+template <class T, size_t L>[[nodiscard]] constexpr Vector<T, L> Min(const Vector<T, L>& a, const Vector<T, L>& b) noexcept
+{
+    Vector<T, L> r;
+    for (size_t i = 0; i < L; ++i)
+        r[i] = Min(a[i], b[i]);
+    return r;
+}
+
 template <class T1, class T2>[[nodiscard]] constexpr auto Max(T1 a, T2 b) noexcept
 {
     return a > b ? a : b;
@@ -163,6 +177,15 @@ template <class T, size_t L>[[nodiscard]] constexpr T Max(const Vector<T, L>& v)
     return m;
 }
 
+// Component-wise maximum
+template <class T, size_t L>[[nodiscard]] constexpr Vector<T, L> Max(const Vector<T, L>& a, const Vector<T, L>& b) noexcept
+{
+    Vector<T, L> r;
+    for (size_t i = 0; i < L; ++i)
+        r[i] = Max(a[i], b[i]);
+    return r;
+}
+
 template <class T, class U, class V>[[nodiscard]] constexpr auto Clamp(T v, U min, V max) noexcept
 {
     return Max(Min(v, max), min);
@@ -173,6 +196,15 @@ template <class T>[[nodiscard]] constexpr T Abs(T x) noexcept
     return x >= T(0) ? x : -x;
 }
 
+// Component-wise absolute value
+template <class T, size_t L>[[nodiscard]] constexpr Vector<T, L> Abs(const Vector<T, L>& v) noexcept
+{
+    Vector<T, L> r;
+    for (size_t i = 0; i < L; ++i)
+        r[i] = Abs(v[i]);
+    return r;
+}
+
 template <class T>[[nodiscard]] constexpr T Sign(T x) noexcept
 {
     return x >= T(0) ? T(1) : T(-1);
@@ -246,6 +278,13 @@ template <class T, class V = T>
     return IsNearlyEqual(a.v, b.v, tolerance) && IsNearlyEqual(a.s, b.s, tolerance);
 }
 
+template <class T, class V = T>
+[[nodiscard]] constexpr bool IsNearlyEqual(const DualQuaternion<T>& a, const DualQuaternion<T>& b,
+                                           V tolerance = kSmallNumV<V>) noexcept
+{
+    return IsNearlyEqual(a.real, b.real, tolerance) && IsNearlyEqual(a.dual, b.dual, tolerance);
+}
+
 template <class T, class U = T>[[nodiscard]] constexpr bool IsNearlyZero(T a, U tolerance = kSmallNumV<U>) noexcept
 {
     return Abs(a) <= tolerance;
@@ -283,6 +322,19 @@ template <class T, class U, class V>[[nodiscard]] constexpr std::common_type_t<T
 template <size_t L, class T, class U, class V>
 [[nodiscard]] constexpr auto Lerp(const Vector<T, L>& a, const Vector<U, L>& b, V alpha) noexcept
 {
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, L> && std::is_same_v<T, U> && std::is_arithmetic_v<V>)
+    {
+        if (!detail::IsConstantEvaluated())
+        {
+            const auto va = detail::SimdLoad<L>(a.data);
+            const auto vb = detail::SimdLoad<L>(b.data);
+            Vector<T, L> r;
+            detail::SimdStore<L>(r.data, detail::SimdMulAdd(_mm_set1_ps(static_cast<T>(alpha)), _mm_sub_ps(vb, va), va));
+            return r;
+        }
+    }
+#endif
     return a + alpha * (b - a);
 }
 
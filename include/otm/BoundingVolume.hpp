@@ -0,0 +1,379 @@
+#pragma once
+#include "Geometry.hpp"
+#include "SoA.hpp"
+#include <random>
+#include <vector>
+
+/*
+ * Bounding volumes fitted to point sets. Fits of disjoint chunks of a point set combine with AABB::Merge() and
+ * Sphere::Merge(), so large meshes can be split across threads and the results merged. Merged AABBs are exact;
+ * merged spheres are bounding but not minimal.
+ */
+
+namespace otm
+{
+namespace detail
+{
+// Reduce lanes of a pack to one value
+template <class T, class Fn>
+[[nodiscard]] T ReduceLanes(const Pack<T>& p, Fn&& fn) noexcept
+{
+    T lanes[Pack<T>::size];
+    p.Store(lanes);
+    auto r = lanes[0];
+    for (size_t i = 1; i < Pack<T>::size; ++i)
+        r = fn(r, lanes[i]);
+    return r;
+}
+
+// Smallest sphere with a and b on its surface
+[[nodiscard]] inline Sphere SphereThrough(const Vec3& a, const Vec3& b) noexcept
+{
+    return {(a + b) * Float(0.5), a.Dist(b) * Float(0.5)};
+}
+
+// Smallest sphere with a, b and c on its surface. Collinear points fall back to the pair furthest apart.
+[[nodiscard]] inline Sphere SphereThrough(const Vec3& a, const Vec3& b, const Vec3& c) noexcept
+{
+    const auto ab = b - a, ac = c - a;
+    const auto n = ab ^ ac;
+    const auto n_sqr = n | n;
+    if (n_sqr <= kSmallNum * ab.LenSqr() * ac.LenSqr())
+    {
+        const auto bc = ab.DistSqr(ac);
+        if (bc >= ab.LenSqr() && bc >= ac.LenSqr())
+            return SphereThrough(b, c);
+        return ab.LenSqr() >= ac.LenSqr() ? SphereThrough(a, b) : SphereThrough(a, c);
+    }
+
+    const auto offset = ((n ^ ab) * ac.LenSqr() + (ac ^ n) * ab.LenSqr()) / (2 * n_sqr);
+    return {a + offset, offset.Len()};
+}
+
+// Sphere with a, b, c and d on its surface. Coplanar points fall back to the smallest sphere through three of them
+// that contains the fourth.
+[[nodiscard]] inline Sphere SphereThrough(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d) noexcept
+{
+    const auto ab = b - a, ac = c - a, ad = d - a;
+    const auto det = ab | (ac ^ ad);
+    if (Abs(det) <= kSmallNum * std::sqrt(ab.LenSqr() * ac.LenSqr() * ad.LenSqr()))
+    {
+        const Vec3 p[4]{a, b, c, d};
+        Sphere best{Vec3{}, kInf};
+        for (size_t skip = 0; skip < 4; ++skip)
+        {
+            const auto& x = p[skip == 0 ? 1 : 0];
+            const auto& y = p[skip <= 1 ? 2 : 1];
+            const auto& z = p[skip <= 2 ? 3 : 2];
+            const auto s = SphereThrough(x, y, z);
+            const auto limit = s.radius * s.radius * (1 + 4 * kSmallNum);
+            if (s.radius < best.radius && p[skip].DistSqr(s.pos) <= limit)
+                best = s;
+        }
+        return best;
+    }
+
+    const auto offset = ((ac ^ ad) * ab.LenSqr() + (ad ^ ab) * ac.LenSqr() + (ab ^ ac) * ad.LenSqr()) / (2 * det);
+    return {a + offset, offset.Len()};
+}
+
+/**
+ * \brief Eigen decomposition of a symmetric matrix by cyclic Jacobi rotations
+ * \param vectors Receives the unit eigenvectors as rows, in the same order as the returned eigenvalues
+ */
+[[nodiscard]] inline Vec3 SymmetricEigen(Mat3 a, Mat3& vectors) noexcept
+{
+    auto v = Mat3::Identity();
+    for (size_t sweep = 0; sweep < 32; ++sweep)
+    {
+        const auto off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        const auto diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+        if (off <= kSmallNum * kSmallNum * diag || off == 0)
+            break;
+
+        for (const auto& [p, q] : {std::pair{0, 1}, std::pair{0, 2}, std::pair{1, 2}})
+        {
+            if (a[p][q] == 0)
+                continue;
+
+            // Rotation in the pq plane that zeroes a[p][q]
+            const auto theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+            const auto t = (theta >= 0 ? Float(1) : Float(-1)) / (Abs(theta) + std::sqrt(theta * theta + 1));
+            const auto c = 1 / std::sqrt(t * t + 1), s = t * c;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const auto kp = a[k][p], kq = a[k][q];
+                a[k][p] = c * kp - s * kq;
+                a[k][q] = s * kp + c * kq;
+            }
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const auto pk = a[p][k], qk = a[q][k];
+                a[p][k] = c * pk - s * qk;
+                a[q][k] = s * pk + c * qk;
+            }
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const auto kp = v[k][p], kq = v[k][q];
+                v[k][p] = c * kp - s * kq;
+                v[k][q] = s * kp + c * kq;
+            }
+        }
+    }
+
+    vectors = v.Transposed();
+    return {a[0][0], a[1][1], a[2][2]};
+}
+}
+
+/**
+ * \return Bounds of the points, or AABB::Empty() if there are none
+ */
+[[nodiscard]] inline AABB Bounds(const Vec3* points, size_t count) noexcept
+{
+    auto box = AABB::Empty();
+    for (size_t i = 0; i < count; ++i)
+        box.Merge(points[i]);
+    return box;
+}
+
+/**
+ * \brief Bounds of the points, Pack::size at a time
+ * \return Bounds of the points, or AABB::Empty() if there are none
+ */
+[[nodiscard]] inline AABB Bounds(const SoA<Vec3>& points) noexcept
+{
+    using Pack = SoA<Vec3>::Pack;
+
+    Vector<Pack, 3> lo, hi;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        lo[c] = Pack::Set1(kInf);
+        hi[c] = Pack::Set1(-kInf);
+    }
+
+    // Padding would count as points at the origin, so the partial pack at the end goes one by one
+    size_t i = 0;
+    for (; i + Pack::size <= points.size(); i += Pack::size)
+    {
+        const auto p = points.LoadPack(i);
+        for (size_t c = 0; c < 3; ++c)
+        {
+            lo[c] = Min(lo[c], p[c]);
+            hi[c] = Max(hi[c], p[c]);
+        }
+    }
+
+    AABB box;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        box.min[c] = detail::ReduceLanes(lo[c], [](Float x, Float y) { return Min(x, y); });
+        box.max[c] = detail::ReduceLanes(hi[c], [](Float x, Float y) { return Max(x, y); });
+    }
+
+    for (; i < points.size(); ++i)
+        box.Merge(points[i]);
+    return box;
+}
+
+/**
+ * \brief Ritter's bounding sphere. Starts from the most distant pair of axis extremes and grows to each point outside.
+ * Two passes over the points; usually 5-20% larger than the minimum sphere.
+ * \param count Must be greater than zero
+ */
+[[nodiscard]] inline Sphere BoundingSphere(const Vec3* points, size_t count) noexcept
+{
+    assert(count > 0);
+
+    size_t lo[3]{}, hi[3]{};
+    for (size_t i = 1; i < count; ++i)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            if (points[i][c] < points[lo[c]][c])
+                lo[c] = i;
+            if (points[i][c] > points[hi[c]][c])
+                hi[c] = i;
+        }
+    }
+
+    size_t axis = 0;
+    for (size_t c = 1; c < 3; ++c)
+        if (points[lo[c]].DistSqr(points[hi[c]]) > points[lo[axis]].DistSqr(points[hi[axis]]))
+            axis = c;
+
+    auto s = detail::SphereThrough(points[lo[axis]], points[hi[axis]]);
+    for (size_t i = 0; i < count; ++i)
+        s.Merge(points[i]);
+    return s;
+}
+
+/**
+ * \brief Ritter's bounding sphere, Pack::size at a time. Same result as BoundingSphere() on the same points in the same order.
+ * \param points Must not be empty
+ */
+[[nodiscard]] inline Sphere BoundingSphere(const SoA<Vec3>& points) noexcept
+{
+    using Pack = SoA<Vec3>::Pack;
+    assert(!points.empty());
+
+    // Lanes past the end are padding. Visit the set bits of mask for the real points only.
+    const auto ForEachLane = [&](size_t i, uint32_t mask, auto&& fn)
+    {
+        for (size_t lane = 0; mask != 0 && i + lane < points.size(); ++lane, mask >>= 1)
+            if (mask & 1)
+                fn(i + lane);
+    };
+
+    // The first point at each extreme, found by comparing packs against the bounds
+    const auto box = Bounds(points);
+    size_t lo[3]{}, hi[3]{};
+    bool found_lo[3]{}, found_hi[3]{};
+    Vector<Pack, 3> box_min, box_max;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        box_min[c] = Pack::Set1(box.min[c]);
+        box_max[c] = Pack::Set1(box.max[c]);
+    }
+
+    for (size_t i = 0; i < points.PaddedSize(); i += Pack::size)
+    {
+        const auto p = points.LoadPack(i);
+        for (size_t c = 0; c < 3; ++c)
+        {
+            if (!found_lo[c])
+            {
+                ForEachLane(i, MaskGreaterEqual(box_min[c], p[c]), [&](size_t k)
+                {
+                    if (!found_lo[c] && points.Data(c)[k] <= box.min[c])
+                    {
+                        lo[c] = k;
+                        found_lo[c] = true;
+                    }
+                });
+            }
+            if (!found_hi[c])
+            {
+                ForEachLane(i, MaskGreaterEqual(p[c], box_max[c]), [&](size_t k)
+                {
+                    if (!found_hi[c] && points.Data(c)[k] >= box.max[c])
+                    {
+                        hi[c] = k;
+                        found_hi[c] = true;
+                    }
+                });
+            }
+        }
+    }
+
+    size_t axis = 0;
+    for (size_t c = 1; c < 3; ++c)
+        if (points[lo[c]].DistSqr(points[hi[c]]) > points[lo[axis]].DistSqr(points[hi[axis]]))
+            axis = c;
+
+    // Points inside the sphere are skipped a pack at a time; only packs with a point outside go one by one
+    auto s = detail::SphereThrough(points[lo[axis]], points[hi[axis]]);
+    for (size_t i = 0; i < points.PaddedSize(); i += Pack::size)
+    {
+        const auto p = points.LoadPack(i);
+        Vector<Pack, 3> center;
+        for (size_t c = 0; c < 3; ++c)
+            center[c] = Pack::Set1(s.pos[c]);
+        const auto d = p - center;
+        const auto mask = MaskGreaterEqual(d | d, Pack::Set1(s.radius * s.radius));
+        ForEachLane(i, mask, [&](size_t k) { s.Merge(points[k]); });
+    }
+    return s;
+}
+
+/**
+ * \brief Minimum bounding sphere by Welzl's randomized incremental algorithm. Expected linear time.
+ * Points are visited in a shuffled order seeded by count, so the result is deterministic.
+ * \param count Must be greater than zero
+ */
+[[nodiscard]] inline Sphere MinBoundingSphere(const Vec3* points, size_t count)
+{
+    assert(count > 0);
+
+    std::vector<Vec3> p(points, points + count);
+    std::shuffle(p.begin(), p.end(), std::minstd_rand{static_cast<std::minstd_rand::result_type>(count)});
+
+    // Rounding in the circumsphere must not make its own defining points fall outside
+    const auto Contains = [](const Sphere& s, const Vec3& x)
+    {
+        return x.DistSqr(s.pos) <= s.radius * s.radius * (1 + 4 * kSmallNum);
+    };
+
+    // Each loop finds the minimum sphere of the points before it with the points of the enclosing loops on its surface
+    Sphere s{p[0], 0};
+    for (size_t i = 1; i < count; ++i)
+    {
+        if (Contains(s, p[i]))
+            continue;
+
+        s = {p[i], 0};
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (Contains(s, p[j]))
+                continue;
+
+            s = detail::SphereThrough(p[i], p[j]);
+            for (size_t k = 0; k < j; ++k)
+            {
+                if (Contains(s, p[k]))
+                    continue;
+
+                s = detail::SphereThrough(p[i], p[j], p[k]);
+                for (size_t l = 0; l < k; ++l)
+                    if (!Contains(s, p[l]))
+                        s = detail::SphereThrough(p[i], p[j], p[k], p[l]);
+            }
+        }
+    }
+    return s;
+}
+
+/**
+ * \brief Box aligned to the principal axes of the points. Tight for elongated point sets;
+ * for nearly symmetric sets the axes are arbitrary and the box may be no better than the AABB.
+ * \param count Must be greater than zero
+ */
+[[nodiscard]] inline OBB BoundingOBB(const Vec3* points, size_t count) noexcept
+{
+    assert(count > 0);
+
+    Vec3 mean;
+    for (size_t i = 0; i < count; ++i)
+        mean += points[i];
+    mean /= static_cast<Float>(count);
+
+    Mat3 cov;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto d = points[i] - mean;
+        for (size_t r = 0; r < 3; ++r)
+            for (size_t c = r; c < 3; ++c)
+                cov[r][c] += d[r] * d[c];
+    }
+    for (size_t r = 0; r < 3; ++r)
+        for (size_t c = 0; c < r; ++c)
+            cov[r][c] = cov[c][r];
+
+    Mat3 axes;
+    (void)detail::SymmetricEigen(cov, axes);
+    axes[2] = axes[0] ^ axes[1];
+
+    Vec3 lo{All{}, kInf}, hi{All{}, -kInf};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto d = points[i] - mean;
+        const Vec3 local{d | axes[0], d | axes[1], d | axes[2]};
+        lo = Min(lo, local);
+        hi = Max(hi, local);
+    }
+
+    const auto mid = (lo + hi) * Float(0.5);
+    return {mean + mid * axes, axes, (hi - lo) * Float(0.5)};
+}
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include "Transform.hpp"
+
+/*
+ * Dual quaternions represent rigid transforms, rotation followed by translation, in 8 numbers. Blending them
+ * (dual quaternion linear blending, DLB) keeps volume where blending matrices collapses twisted joints,
+ * so they suit skinning, and they pack a palette in half the memory of 4x4 matrices.
+ */
+
+namespace otm
+{
+template <class T>
+struct DualQuaternion
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    static const DualQuaternion identity;
+
+    [[nodiscard]] static constexpr DualQuaternion Identity() noexcept
+    {
+        return {};
+    }
+
+    Quaternion<T> real; // Rotation
+    Quaternion<T> dual{Vector<T, 3>{}, 0}; // Translation t as (t, 0) * real / 2
+
+    constexpr DualQuaternion() noexcept = default;
+    constexpr DualQuaternion(const Quaternion<T>& real, const Quaternion<T>& dual) noexcept: real{real}, dual{dual} {}
+
+    /**
+     * \param rot Must be normalized
+     */
+    constexpr DualQuaternion(const Quaternion<T>& rot, const Vector<T, 3>& pos) noexcept
+        : real{rot}, dual{Quaternion<T>{pos, 0} * rot * T(0.5)}
+    {
+    }
+
+    explicit constexpr DualQuaternion(const Vector<T, 3>& pos) noexcept: DualQuaternion{Quaternion<T>{}, pos} {}
+    explicit constexpr DualQuaternion(const Quaternion<T>& rot) noexcept: real{rot} {}
+
+    /**
+     * \note Scale is dropped; dual quaternions are rigid
+     */
+    explicit constexpr DualQuaternion(const Transform& t) noexcept: DualQuaternion{t.rot, t.pos} {}
+
+    [[nodiscard]] constexpr const Quaternion<T>& Rotation() const noexcept
+    {
+        return real;
+    }
+
+    [[nodiscard]] constexpr Vector<T, 3> Translation() const noexcept
+    {
+        // Vector part of 2 * dual * conjugate(real), expanded
+        return (dual.v * real.s - real.v * dual.s + (real.v ^ dual.v)) * 2;
+    }
+
+    /**
+     * \brief Transform with unit scale. Must be normalized.
+     */
+    [[nodiscard]] constexpr Transform ToTransform() const noexcept
+    {
+        return {Translation(), real};
+    }
+
+    /**
+     * \brief Rotate, then translate. Must be normalized.
+     */
+    [[nodiscard]] constexpr Vector<T, 3> TransformPoint(const Vector<T, 3>& p) const noexcept
+    {
+        return p.RotatedByUnit(real) + Translation();
+    }
+
+    /**
+     * \brief Rotate only. Must be normalized.
+     */
+    [[nodiscard]] constexpr Vector<T, 3> TransformVector(const Vector<T, 3>& v) const noexcept
+    {
+        return v.RotatedByUnit(real);
+    }
+
+    /**
+     * \brief Scale to unit real part and make the dual part orthogonal to it, which any rigid transform satisfies.
+     * Sums and products drift away from both; the transform they stand for doesn't change.
+     */
+    void Normalize() noexcept
+    {
+        const auto inv_len = 1 / real.Len();
+        real *= inv_len;
+        dual *= inv_len;
+        dual = dual - real * (real | dual);
+    }
+
+    [[nodiscard]] DualQuaternion Normalized() const noexcept
+    {
+        auto t = *this;
+        t.Normalize();
+        return t;
+    }
+
+    /**
+     * \brief Inverse of a normalized dual quaternion
+     */
+    [[nodiscard]] constexpr DualQuaternion Inverse() const noexcept
+    {
+        return {*real, *dual};
+    }
+
+    /**
+     * \brief Apply this, then b. Same as DualQuaternion{ToTransform() * b.ToTransform()}
+     */
+    constexpr DualQuaternion operator*(const DualQuaternion& b) const noexcept
+    {
+        return {b.real * real, b.real * dual + b.dual * real};
+    }
+
+    constexpr DualQuaternion& operator*=(const DualQuaternion& b) noexcept { return *this = *this * b; }
+
+    constexpr DualQuaternion operator+(const DualQuaternion& b) const noexcept { return {real + b.real, dual + b.dual}; }
+    constexpr DualQuaternion operator*(T f) const noexcept { return {real * f, dual * f}; }
+    constexpr DualQuaternion operator-() const noexcept { return {-real, -dual}; }
+};
+
+template <class T>
+inline const DualQuaternion<T> DualQuaternion<T>::identity = Identity();
+
+/**
+ * \brief Dual quaternion linear blending of one vertex's bone influences: the weighted sum, normalized.
+ * Each influence is flipped onto the hemisphere of the first so blending takes the shorter path.
+ * \param palette Normalized dual quaternion of each bone
+ * \param bones Index into palette of each influence
+ * \param weights Weight of each influence. Zero weights are allowed, but not all of them
+ * \param count Number of influences
+ */
+template <class T>
+[[nodiscard]] DualQuaternion<T> Blend(const DualQuaternion<T>* palette, const uint32_t* bones, const T* weights,
+                                      size_t count) noexcept
+{
+    assert(count > 0);
+
+    const auto& first = palette[bones[0]].real;
+    DualQuaternion<T> sum{Quaternion<T>{Vector<T, 3>{}, 0}, Quaternion<T>{Vector<T, 3>{}, 0}};
+    for (size_t k = 0; k < count; ++k)
+    {
+        const auto& dq = palette[bones[k]];
+        sum = sum + dq * ((dq.real | first) < 0 ? -weights[k] : weights[k]);
+    }
+    return sum.Normalized();
+}
+
+/**
+ * \brief Skin points by dual quaternion linear blending, Pack::size points at a time.
+ * Same as out[i] = Blend(palette, bones + i * N, weights + i * N, N).TransformPoint(in[i])
+ * \tparam N Number of influences per point. Unused influences have zero weight
+ * \param bones Bone indices into palette, N per point
+ * \param weights Weights, N per point
+ * \param out Output points. May be the same as in
+ */
+template <size_t N, class T>
+void SkinPoints(const DualQuaternion<T>* palette, const uint32_t* bones, const T* weights, const Vector<T, 3>* in,
+                Vector<T, 3>* out, size_t count) noexcept
+{
+    static_assert(N > 0);
+    using Pack = detail::Pack<T>;
+    constexpr auto W = Pack::size;
+
+    const auto zero = Pack::Set1(0), one = Pack::Set1(1), two = Pack::Set1(2);
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        // Influence k of W points, one per lane
+        Vector<Pack, 4> first, real, dual;
+        for (size_t k = 0; k < N; ++k)
+        {
+            T lanes[9][W];
+            for (size_t l = 0; l < W; ++l)
+            {
+                const auto& dq = palette[bones[(i + l) * N + k]];
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    lanes[c][l] = dq.real.v[c];
+                    lanes[4 + c][l] = dq.dual.v[c];
+                }
+                lanes[3][l] = dq.real.s;
+                lanes[7][l] = dq.dual.s;
+                lanes[8][l] = weights[(i + l) * N + k];
+            }
+
+            Vector<Pack, 4> r, d;
+            for (size_t c = 0; c < 4; ++c)
+            {
+                r[c] = Pack::Load(lanes[c]);
+                d[c] = Pack::Load(lanes[4 + c]);
+            }
+
+            auto w = Pack::Load(lanes[8]);
+            if (k == 0)
+                first = r;
+            else
+                w = SelectGreater(zero, r | first, -w, w);
+
+            for (size_t c = 0; c < 4; ++c)
+            {
+                real[c] = MulAdd(w, r[c], real[c]);
+                dual[c] = MulAdd(w, d[c], dual[c]);
+            }
+        }
+
+        // Normalizing the real part is enough; the dual part's component along it doesn't affect points
+        const auto inv_len = one / Sqrt(real | real);
+        const Vector<Pack, 3> rv{real[0] * inv_len, real[1] * inv_len, real[2] * inv_len};
+        const Vector<Pack, 3> dv{dual[0] * inv_len, dual[1] * inv_len, dual[2] * inv_len};
+        const auto rs = real[3] * inv_len, ds = dual[3] * inv_len;
+
+        T points[3][W];
+        for (size_t l = 0; l < W; ++l)
+            for (size_t c = 0; c < 3; ++c)
+                points[c][l] = in[i + l][c];
+        const Vector<Pack, 3> p{Pack::Load(points[0]), Pack::Load(points[1]), Pack::Load(points[2])};
+
+        // Same as RotatedByUnit() and Translation()
+        const auto t = (rv ^ p) * two;
+        const auto q = p + t * rs + (rv ^ t) + (dv * rs - rv * ds + (rv ^ dv)) * two;
+
+        for (size_t c = 0; c < 3; ++c)
+            q[c].Store(points[c]);
+        for (size_t l = 0; l < W; ++l)
+            out[i + l] = {points[0][l], points[1][l], points[2][l]};
+    }
+
+    for (; i < count; ++i)
+        out[i] = Blend(palette, bones + i * N, weights + i * N, N).TransformPoint(in[i]);
+}
+}
@@ -0,0 +1,316 @@
+#pragma once
+#include "Matrix.hpp"
+#include <functional>
+
+/*
+ * Opt-in expression templates for element-wise Vector/Matrix arithmetic.
+ * Wrap each Vector/Matrix operand with Lazy() and the whole expression is evaluated in a single loop without temporaries:
+ *
+ *     Vector<float, 16> r = Lazy(a) * s + Lazy(b) * t - Lazy(c);
+ *
+ * a * b + c patterns are fused into FMA if OTM_SIMD is enabled and FMA is available.
+ * Expressions hold references to their operands, so don't store them (e.g. with auto); evaluate them right away.
+ */
+
+namespace otm
+{
+namespace detail
+{
+template <class T>
+struct ExprShape;
+
+template <class T, size_t L>
+struct ExprShape<Vector<T, L>>
+{
+    static constexpr size_t size = L;
+
+    template <class U>
+    using Rebind = Vector<U, L>;
+
+    [[nodiscard]] static constexpr T Get(const Vector<T, L>& v, size_t i) noexcept
+    {
+        return v[i];
+    }
+
+    static constexpr void Set(Vector<T, L>& v, size_t i, T x) noexcept
+    {
+        v[i] = x;
+    }
+};
+
+template <class T, size_t R, size_t C>
+struct ExprShape<Matrix<T, R, C>>
+{
+    static constexpr size_t size = R * C;
+
+    template <class U>
+    using Rebind = Matrix<U, R, C>;
+
+    [[nodiscard]] static constexpr T Get(const Matrix<T, R, C>& m, size_t i) noexcept
+    {
+        return m[i / C][i % C];
+    }
+
+    static constexpr void Set(Matrix<T, R, C>& m, size_t i, T x) noexcept
+    {
+        m[i / C][i % C] = x;
+    }
+};
+
+template <class T>
+[[nodiscard]] constexpr T FusedMulAdd(T a, T b, T c) noexcept
+{
+#if OTM_SIMD_FMA
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (!IsConstantEvaluated())
+            return std::fma(a, b, c);
+    }
+#endif
+    return a * b + c;
+}
+}
+
+/**
+ * \brief Base of all expressions
+ * \tparam E Derived expression type. Must have `Value`, `Shape`, and `operator[](size_t)`
+ */
+template <class E>
+struct Expr
+{
+    [[nodiscard]] constexpr const E& Self() const noexcept
+    {
+        return static_cast<const E&>(*this);
+    }
+
+    /**
+     * \brief Evaluate the expression in a single loop
+     */
+    [[nodiscard]] constexpr auto Eval() const noexcept
+    {
+        using Shape = typename E::Shape;
+        typename Shape::template Rebind<typename E::Value> r{};
+        for (size_t i = 0; i < Shape::size; ++i)
+            detail::ExprShape<decltype(r)>::Set(r, i, Self()[i]);
+        return r;
+    }
+
+    template <class V, class E2 = E, std::enable_if_t<std::is_same_v<V, typename E2::Shape::template Rebind<typename E2::Value>>, int>  = 0>
+    constexpr operator V() const noexcept
+    {
+        return Eval();
+    }
+};
+
+/**
+ * \brief Leaf expression referring to Vector or Matrix
+ */
+template <class V>
+struct RefExpr : Expr<RefExpr<V>>
+{
+    using Shape = detail::ExprShape<V>;
+    using Value = typename V::value_type;
+
+    constexpr explicit RefExpr(const V& v) noexcept
+        : v{v}
+    {
+    }
+
+    [[nodiscard]] constexpr auto operator[](size_t i) const noexcept
+    {
+        return Shape::Get(v, i);
+    }
+
+    const V& v;
+};
+
+template <class T, size_t R, size_t C>
+struct RefExpr<Matrix<T, R, C>> : Expr<RefExpr<Matrix<T, R, C>>>
+{
+    using Shape = detail::ExprShape<Matrix<T, R, C>>;
+    using Value = T;
+
+    constexpr explicit RefExpr(const Matrix<T, R, C>& v) noexcept
+        : v{v}
+    {
+    }
+
+    [[nodiscard]] constexpr T operator[](size_t i) const noexcept
+    {
+        return Shape::Get(v, i);
+    }
+
+    const Matrix<T, R, C>& v;
+};
+
+/**
+ * \brief Scalar broadcasted to every element
+ */
+template <class T, class S>
+struct ScalarExpr : Expr<ScalarExpr<T, S>>
+{
+    using Shape = S;
+    using Value = T;
+
+    constexpr explicit ScalarExpr(T x) noexcept
+        : x{x}
+    {
+    }
+
+    [[nodiscard]] constexpr T operator[](size_t) const noexcept
+    {
+        return x;
+    }
+
+    T x;
+};
+
+namespace detail
+{
+template <class E>
+struct IsScalarExpr : std::false_type
+{
+};
+
+template <class T, class S>
+struct IsScalarExpr<ScalarExpr<T, S>> : std::true_type
+{
+};
+
+// Same kind of Vector or Matrix with the same dimensions, whatever the element types. A scalar fits any shape.
+template <class A, class B>
+inline constexpr bool kSameShape = IsScalarExpr<A>::value || IsScalarExpr<B>::value
+    || std::is_same_v<typename A::Shape::template Rebind<int>, typename B::Shape::template Rebind<int>>;
+}
+
+template <class Op, class A, class B>
+struct BinaryExpr : Expr<BinaryExpr<Op, A, B>>
+{
+    static_assert(detail::kSameShape<A, B>, "Shape mismatch");
+
+    using Shape = typename A::Shape;
+    using Value = std::common_type_t<typename A::Value, typename B::Value>;
+
+    constexpr BinaryExpr(const A& a, const B& b) noexcept
+        : a{a}, b{b}
+    {
+    }
+
+    [[nodiscard]] constexpr Value operator[](size_t i) const noexcept
+    {
+        constexpr auto kAdd = std::is_same_v<Op, std::plus<>>;
+        constexpr auto kSub = std::is_same_v<Op, std::minus<>>;
+
+        // Fuse a * b + c
+        if constexpr ((kAdd || kSub) && IsMul<A>::value)
+            return detail::FusedMulAdd<Value>(a.a[i], a.b[i], kAdd ? Value(b[i]) : -Value(b[i]));
+        else if constexpr ((kAdd || kSub) && IsMul<B>::value)
+            return detail::FusedMulAdd<Value>(kAdd ? Value(b.a[i]) : -Value(b.a[i]), b.b[i], a[i]);
+        else
+            return Op{}(a[i], b[i]);
+    }
+
+    A a;
+    B b;
+
+private:
+    template <class X>
+    struct IsMul : std::false_type
+    {
+    };
+
+    template <class X, class Y>
+    struct IsMul<BinaryExpr<std::multiplies<>, X, Y>> : std::true_type
+    {
+    };
+};
+
+template <class A>
+struct NegExpr : Expr<NegExpr<A>>
+{
+    using Shape = typename A::Shape;
+    using Value = typename A::Value;
+
+    constexpr explicit NegExpr(const A& a) noexcept
+        : a{a}
+    {
+    }
+
+    [[nodiscard]] constexpr Value operator[](size_t i) const noexcept
+    {
+        return -a[i];
+    }
+
+    A a;
+};
+
+/**
+ * \brief Start an expression. Following operations are evaluated lazily.
+ */
+template <class T, size_t L>
+[[nodiscard]] constexpr RefExpr<Vector<T, L>> Lazy(const Vector<T, L>& v) noexcept
+{
+    return RefExpr<Vector<T, L>>{v};
+}
+
+template <class T, size_t R, size_t C>
+[[nodiscard]] constexpr RefExpr<Matrix<T, R, C>> Lazy(const Matrix<T, R, C>& m) noexcept
+{
+    return RefExpr<Matrix<T, R, C>>{m};
+}
+
+template <class E>
+[[nodiscard]] constexpr auto Eval(const Expr<E>& e) noexcept
+{
+    return e.Eval();
+}
+
+// Expression with expression. Multiplication is element-wise.
+
+template <class A, class B>
+constexpr BinaryExpr<std::plus<>, A, B> operator+(const Expr<A>& a, const Expr<B>& b) noexcept
+{
+    return {a.Self(), b.Self()};
+}
+
+template <class A, class B>
+constexpr BinaryExpr<std::minus<>, A, B> operator-(const Expr<A>& a, const Expr<B>& b) noexcept
+{
+    return {a.Self(), b.Self()};
+}
+
+template <class A, class B>
+constexpr BinaryExpr<std::multiplies<>, A, B> operator*(const Expr<A>& a, const Expr<B>& b) noexcept
+{
+    return {a.Self(), b.Self()};
+}
+
+// Expression with scalar
+
+template <class E, class F, std::enable_if_t<std::is_arithmetic_v<F>, int>  = 0>
+constexpr auto operator*(const Expr<E>& e, F f) noexcept
+{
+    using S = ScalarExpr<F, typename E::Shape>;
+    return BinaryExpr<std::multiplies<>, E, S>{e.Self(), S{f}};
+}
+
+template <class E, class F, std::enable_if_t<std::is_arithmetic_v<F>, int>  = 0>
+constexpr auto operator*(F f, const Expr<E>& e) noexcept
+{
+    using S = ScalarExpr<F, typename E::Shape>;
+    return BinaryExpr<std::multiplies<>, S, E>{S{f}, e.Self()};
+}
+
+template <class E, class F, std::enable_if_t<std::is_arithmetic_v<F>, int>  = 0>
+constexpr auto operator/(const Expr<E>& e, F f) noexcept
+{
+    using S = ScalarExpr<F, typename E::Shape>;
+    return BinaryExpr<std::divides<>, E, S>{e.Self(), S{f}};
+}
+
+template <class E>
+constexpr NegExpr<E> operator-(const Expr<E>& e) noexcept
+{
+    return NegExpr<E>{e.Self()};
+}
+}
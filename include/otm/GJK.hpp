@@ -0,0 +1,608 @@
+#pragma once
+#include "Transform.hpp"
+#include <algorithm>
+#include <initializer_list>
+
+/*
+ * GJK distance and EPA penetration depth between convex shapes described only by their support function:
+ *
+ *     Vec3 Support(const Shape& shape, const Vec3& dir); // Point of the shape furthest along dir
+ *
+ * Overloads are provided for Sphere, AABB, OBB, Capsule, Triangle, ConvexHull and Transformed<Shape>, so any two of
+ * them can be tested against each other. Define Support() for your own shape in its namespace and it is found by
+ * argument-dependent lookup.
+ */
+
+namespace otm
+{
+/**
+ * \brief Convex hull of points, for Support(). Doesn't own the points, which need not all be on the hull.
+ */
+struct ConvexHull
+{
+    const Vec3* points;
+    size_t count; // Must be at least 1
+};
+
+/**
+ * \brief Shape defined in local space, placed by a transform
+ */
+template <class Shape>
+struct Transformed
+{
+    Shape shape;
+    Transform transform;
+};
+
+template <class Shape>
+Transformed(Shape, Transform) -> Transformed<Shape>;
+
+[[nodiscard]] inline Vec3 Support(const Sphere& s, const Vec3& dir) noexcept
+{
+    const auto len_sqr = dir.LenSqr();
+    return len_sqr > 0 ? s.pos + dir * (s.radius / std::sqrt(len_sqr)) : s.pos;
+}
+
+[[nodiscard]] constexpr Vec3 Support(const AABB& b, const Vec3& dir) noexcept
+{
+    return {dir[0] >= 0 ? b.max[0] : b.min[0], dir[1] >= 0 ? b.max[1] : b.min[1], dir[2] >= 0 ? b.max[2] : b.min[2]};
+}
+
+[[nodiscard]] constexpr Vec3 Support(const OBB& b, const Vec3& dir) noexcept
+{
+    auto p = b.center;
+    for (size_t i = 0; i < 3; ++i)
+        p += b.axes[i] * ((dir | b.axes[i]) >= 0 ? b.extent[i] : -b.extent[i]);
+    return p;
+}
+
+[[nodiscard]] inline Vec3 Support(const Capsule& c, const Vec3& dir) noexcept
+{
+    return Support(Sphere{(dir | c.a) >= (dir | c.b) ? c.a : c.b, c.radius}, dir);
+}
+
+[[nodiscard]] constexpr Vec3 Support(const Triangle& t, const Vec3& dir) noexcept
+{
+    const auto da = dir | t.a, db = dir | t.b, dc = dir | t.c;
+    return da >= db ? (da >= dc ? t.a : t.c) : (db >= dc ? t.b : t.c);
+}
+
+[[nodiscard]] inline Vec3 Support(const ConvexHull& hull, const Vec3& dir) noexcept
+{
+    assert(hull.count > 0);
+    size_t best = 0;
+    auto best_dot = dir | hull.points[0];
+    for (size_t i = 1; i < hull.count; ++i)
+    {
+        if (const auto dot = dir | hull.points[i]; dot > best_dot)
+        {
+            best_dot = dot;
+            best = i;
+        }
+    }
+    return hull.points[best];
+}
+
+template <class Shape>
+[[nodiscard]] Vec3 Support(const Transformed<Shape>& t, const Vec3& dir) noexcept
+{
+    // Maximizing dir | R(S p) is maximizing S R^-1 dir | p
+    const auto local_dir = dir.RotatedByUnit(*t.transform.rot) * t.transform.scale;
+    return t.transform.TransformPoint(Support(t.shape, local_dir));
+}
+
+/**
+ * \brief Simplex GJK ended with. Pass the same one to the next query between the same pair of shapes, and the query
+ * starts from the same support directions evaluated at the new poses; persistent contacts then converge in an
+ * iteration or two.
+ */
+struct GjkSimplex
+{
+    struct Vertex
+    {
+        Vec3 a; // Support point of the first shape
+        Vec3 b; // Support point of the second shape, in the opposite direction
+        Vec3 w; // a - b, a point of the Minkowski difference
+        Vec3 dir; // Direction a was taken in
+    };
+
+    Vertex vertices[4];
+    size_t size = 0;
+};
+
+struct GjkResult
+{
+    Float distance; // 0 if overlapping
+    Vec3 point_a; // Closest point on the first shape. Meaningless if overlapping
+    Vec3 point_b; // Closest point on the second shape. Meaningless if overlapping
+    size_t iterations;
+
+    [[nodiscard]] bool IsOverlapped() const noexcept
+    {
+        return distance <= 0;
+    }
+};
+
+struct Contact
+{
+    Vec3 normal; // From the first shape toward the second. Moving the second by normal * depth separates them
+    Float depth;
+    Vec3 point_a; // Deepest point of the first shape inside the second
+    Vec3 point_b; // Deepest point of the second shape inside the first
+};
+
+namespace detail
+{
+template <class A, class B>
+[[nodiscard]] GjkSimplex::Vertex GjkSupport(const A& a, const B& b, const Vec3& dir) noexcept
+{
+    const auto pa = Support(a, dir), pb = Support(b, -dir);
+    return {pa, pb, pa - pb, dir};
+}
+
+// Keep only the listed vertices, which must be in increasing order
+inline void GjkKeep(GjkSimplex& s, std::initializer_list<size_t> indices) noexcept
+{
+    size_t n = 0;
+    for (const auto i : indices)
+        s.vertices[n++] = s.vertices[i];
+    s.size = n;
+}
+
+/*
+ * Closest point to the origin on the simplex (Ericson, Real-Time Collision Detection 5.1).
+ * Drops vertices not needed to express it and writes barycentric weights of the rest.
+ */
+
+[[nodiscard]] inline Vec3 GjkClosestOnSegment(GjkSimplex& s, Float* weights) noexcept
+{
+    const auto a = s.vertices[0].w, b = s.vertices[1].w;
+    const auto ab = b - a;
+    const auto len_sqr = ab.LenSqr();
+    const auto t = len_sqr > 0 ? -(a | ab) / len_sqr : Float(0);
+
+    if (t <= 0)
+    {
+        GjkKeep(s, {0});
+        weights[0] = 1;
+        return a;
+    }
+    if (t >= 1)
+    {
+        GjkKeep(s, {1});
+        weights[0] = 1;
+        return b;
+    }
+
+    weights[0] = 1 - t;
+    weights[1] = t;
+    return a + ab * t;
+}
+
+[[nodiscard]] inline Vec3 GjkClosestOnTriangle(GjkSimplex& s, Float* weights) noexcept
+{
+    const auto a = s.vertices[0].w, b = s.vertices[1].w, c = s.vertices[2].w;
+    const auto ab = b - a, ac = c - a;
+
+    const auto d1 = -(ab | a), d2 = -(ac | a);
+    if (d1 <= 0 && d2 <= 0)
+    {
+        GjkKeep(s, {0});
+        weights[0] = 1;
+        return a;
+    }
+
+    const auto d3 = -(ab | b), d4 = -(ac | b);
+    if (d3 >= 0 && d4 <= d3)
+    {
+        GjkKeep(s, {1});
+        weights[0] = 1;
+        return b;
+    }
+
+    const auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+    {
+        const auto t = d1 / (d1 - d3);
+        GjkKeep(s, {0, 1});
+        weights[0] = 1 - t;
+        weights[1] = t;
+        return a + ab * t;
+    }
+
+    const auto d5 = -(ab | c), d6 = -(ac | c);
+    if (d6 >= 0 && d5 <= d6)
+    {
+        GjkKeep(s, {2});
+        weights[0] = 1;
+        return c;
+    }
+
+    const auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+    {
+        const auto t = d2 / (d2 - d6);
+        GjkKeep(s, {0, 2});
+        weights[0] = 1 - t;
+        weights[1] = t;
+        return a + ac * t;
+    }
+
+    const auto va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+    {
+        const auto t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        GjkKeep(s, {1, 2});
+        weights[0] = 1 - t;
+        weights[1] = t;
+        return b + (c - b) * t;
+    }
+
+    // Collinear vertices were fully handled by the edge regions unless rounding got in the way
+    if (va + vb + vc <= 0)
+    {
+        GjkKeep(s, {0, 1});
+        return GjkClosestOnSegment(s, weights);
+    }
+
+    const auto denom = 1 / (va + vb + vc);
+    const auto v = vb * denom, w = vc * denom;
+    weights[0] = 1 - v - w;
+    weights[1] = v;
+    weights[2] = w;
+
+    // The barycentric sum cancels near the origin, so it can be off the plane by more than its own length. Projecting
+    // onto the plane keeps v perpendicular to the face, unless the face is a sliver whose normal is mostly rounding.
+    const auto n = ab ^ ac;
+    const auto n_sqr = n | n;
+    if (n_sqr > std::numeric_limits<Float>::epsilon() * ab.LenSqr() * ac.LenSqr())
+    {
+        // Weights from the areas of the sub-triangles, which lose less to rounding on slivers than those above
+        const auto p = n * ((n | a) / n_sqr);
+        weights[0] = (((b - p) ^ (c - p)) | n) / n_sqr;
+        weights[1] = (((c - p) ^ (a - p)) | n) / n_sqr;
+        weights[2] = 1 - weights[0] - weights[1];
+        return p;
+    }
+    return a + ab * v + ac * w;
+}
+
+/**
+ * \return Closest point, or nullopt if the origin is inside the tetrahedron
+ */
+[[nodiscard]] inline std::optional<Vec3> GjkClosestOnTetrahedron(GjkSimplex& s, Float* weights) noexcept
+{
+    // Each face with the vertex opposite to it
+    constexpr size_t kFaces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+
+    // A flat tetrahedron has no inside; the closest point is on one of its faces. Nearly flat counts, as rounding
+    // rarely leaves coplanar support points exactly flat.
+    const auto& w = s.vertices;
+    const auto ab = w[1].w - w[0].w, ac = w[2].w - w[0].w, ad = w[3].w - w[0].w;
+    const auto flat = Abs((ab ^ ac) | ad) <= kSmallNum * std::sqrt(ab.LenSqr() * ac.LenSqr() * ad.LenSqr());
+
+    std::optional<Vec3> closest;
+    GjkSimplex best;
+    for (const auto& f : kFaces)
+    {
+        // Only faces the origin is in front of
+        const auto& a = w[f[0]].w;
+        const auto n = (w[f[1]].w - a) ^ (w[f[2]].w - a);
+        if (!flat && (-(a | n)) * ((w[f[3]].w - a) | n) >= 0)
+            continue;
+
+        GjkSimplex face;
+        face.vertices[0] = s.vertices[f[0]];
+        face.vertices[1] = s.vertices[f[1]];
+        face.vertices[2] = s.vertices[f[2]];
+        face.size = 3;
+
+        Float face_weights[3];
+        const auto p = GjkClosestOnTriangle(face, face_weights);
+        if (!closest || p.LenSqr() < closest->LenSqr())
+        {
+            closest = p;
+            best = face;
+            std::copy_n(face_weights, 3, weights);
+        }
+    }
+
+    if (closest)
+        s = best;
+    return closest;
+}
+}
+
+/**
+ * \brief Distance between two convex shapes, or whether they overlap
+ * \param simplex Warm start. If not null, the query starts from it and it receives the final simplex
+ * \param tolerance Relative accuracy of the distance
+ */
+template <class A, class B>
+[[nodiscard]] GjkResult Gjk(const A& a, const B& b, GjkSimplex* simplex = nullptr, Float tolerance = kSmallNum,
+                            size_t max_iterations = 64)
+{
+    GjkSimplex local;
+    auto& s = simplex ? *simplex : local;
+
+    if (s.size == 0)
+    {
+        s.vertices[0] = detail::GjkSupport(a, b, Vec3{1, 0, 0});
+        s.size = 1;
+    }
+    else
+    {
+        // Previous support directions at the current poses
+        for (size_t i = 0; i < s.size; ++i)
+            s.vertices[i] = detail::GjkSupport(a, b, s.vertices[i].dir);
+    }
+
+    const auto Solve = [&](Float* weights) -> std::optional<Vec3>
+    {
+        switch (s.size)
+        {
+        case 1:
+            weights[0] = 1;
+            return s.vertices[0].w;
+        case 2:
+            return detail::GjkClosestOnSegment(s, weights);
+        case 3:
+            return detail::GjkClosestOnTriangle(s, weights);
+        default:
+            return detail::GjkClosestOnTetrahedron(s, weights);
+        }
+    };
+
+    Float weights[4];
+    auto v = Solve(weights);
+    GjkResult r{};
+    auto best_sqr = kInf;
+    auto stalled = false;
+    for (; v && r.iterations < max_iterations; ++r.iterations)
+    {
+        const auto dist_sqr = v->LenSqr();
+        best_sqr = Min(best_sqr, dist_sqr);
+        if (dist_sqr <= kSmallNum * kSmallNum)
+        {
+            v.reset();
+            break;
+        }
+
+        // Rounding in the simplex is relative to its largest point, not to v, which is tiny when the shapes nearly
+        // touch (van den Bergen, Collision Detection in Interactive 3D Environments 4.3.6)
+        const auto vertex = detail::GjkSupport(a, b, -*v);
+        auto max_w_sqr = vertex.w.LenSqr();
+        for (size_t i = 0; i < s.size; ++i)
+            max_w_sqr = Max(max_w_sqr, s.vertices[i].w.LenSqr());
+        const auto rounding = std::numeric_limits<Float>::epsilon() * max_w_sqr;
+
+        // Done when the furthest point toward the origin is no closer than v. It must lie beyond the origin too, so
+        // that the plane through it separates the shapes and the rounding allowance can't hide an overlap
+        const auto projected = *v | vertex.w;
+        if (projected > 0 && dist_sqr - projected <= Max(tolerance * dist_sqr, rounding))
+            break;
+
+        // Same for a vertex already in the simplex, which rounding may have let through
+        const auto IsSame = [&](const GjkSimplex::Vertex& x)
+        {
+            return x.w.DistSqr(vertex.w) <= kSmallNum * kSmallNum * max_w_sqr;
+        };
+        if (std::any_of(s.vertices, s.vertices + s.size, IsSame))
+            break;
+
+        // Keep the previous simplex in case adding the vertex makes no progress due to rounding. On curved shapes a
+        // vertex far from v may gain less than rounding and only pay off with the one after it, so one step that
+        // doesn't get closer is let through, but not two in a row.
+        const auto prev = s;
+        s.vertices[s.size++] = vertex;
+        Float new_weights[4];
+        const auto next = Solve(new_weights);
+        if (next)
+        {
+            const auto next_sqr = next->LenSqr();
+            if (next_sqr >= dist_sqr + rounding || (stalled && next_sqr >= best_sqr))
+            {
+                s = prev;
+                break;
+            }
+            stalled = next_sqr >= best_sqr;
+        }
+
+        v = next;
+        std::copy_n(new_weights, 4, weights);
+    }
+
+    if (!v)
+        return r;
+
+    for (size_t i = 0; i < s.size; ++i)
+    {
+        r.point_a += s.vertices[i].a * weights[i];
+        r.point_b += s.vertices[i].b * weights[i];
+    }
+    r.distance = v->Len();
+    return r;
+}
+
+namespace detail
+{
+/**
+ * \brief Grow the polytope around the origin toward the shapes' boundary until the closest face stops moving
+ * \param s Simplex containing the origin
+ */
+template <class A, class B>
+[[nodiscard]] Contact Epa(const A& a, const B& b, const GjkSimplex& s, Float tolerance, size_t max_iterations)
+{
+    constexpr size_t kMaxVertices = 64;
+    constexpr size_t kMaxFaces = kMaxVertices * 2;
+
+    struct Face
+    {
+        uint8_t v[3];
+        Vec3 normal;
+        Float dist;
+    };
+
+    GjkSimplex::Vertex vertices[kMaxVertices];
+    size_t num_vertices = s.size;
+    std::copy_n(s.vertices, s.size, vertices);
+
+    // GJK may stop with the origin on a lower dimensional simplex. Add vertices until it has volume.
+    const auto Expand = [&](std::initializer_list<Vec3> dirs, auto&& adds_dimension)
+    {
+        for (const auto& dir : dirs)
+        {
+            const auto vertex = GjkSupport(a, b, dir);
+            if (adds_dimension(vertex.w))
+            {
+                vertices[num_vertices++] = vertex;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const auto& w0 = vertices[0].w;
+    if (num_vertices == 1)
+    {
+        Expand({Vec3{1, 0, 0}, Vec3{-1, 0, 0}, Vec3{0, 1, 0}, Vec3{0, -1, 0}, Vec3{0, 0, 1}, Vec3{0, 0, -1}},
+               [&](const Vec3& w) { return w.DistSqr(w0) > kSmallNum * kSmallNum; });
+    }
+    if (num_vertices == 2)
+    {
+        const auto d = vertices[1].w - w0;
+        const auto axis = Abs(d[0]) < Abs(d[1]) ? (Abs(d[0]) < Abs(d[2]) ? Vec3{1, 0, 0} : Vec3{0, 0, 1})
+                                                : (Abs(d[1]) < Abs(d[2]) ? Vec3{0, 1, 0} : Vec3{0, 0, 1});
+        const auto p = d ^ axis, q = d ^ p;
+        Expand({p, -p, q, -q}, [&](const Vec3& w) { return ((w - w0) ^ d).LenSqr() > kSmallNum * kSmallNum * d.LenSqr(); });
+    }
+    if (num_vertices == 3)
+    {
+        const auto n = (vertices[1].w - w0) ^ (vertices[2].w - w0);
+        Expand({n, -n}, [&](const Vec3& w) { return Abs((w - w0) | n) > kSmallNum * n.Len(); });
+    }
+
+    // Touching flat shapes have no volume to expand into
+    if (num_vertices < 4)
+        return {Vec3{1, 0, 0}, 0, vertices[0].a, vertices[0].b};
+
+    Face faces[kMaxFaces];
+    size_t num_faces = 0;
+
+    const auto AddFace = [&](size_t i, size_t j, size_t k)
+    {
+        auto& f = faces[num_faces++];
+        f.v[0] = static_cast<uint8_t>(i);
+        f.v[1] = static_cast<uint8_t>(j);
+        f.v[2] = static_cast<uint8_t>(k);
+        const auto n = (vertices[j].w - vertices[i].w) ^ (vertices[k].w - vertices[i].w);
+        if (const auto u = n.Unit())
+        {
+            f.normal = u->Get();
+            f.dist = f.normal | vertices[i].w;
+        }
+        else
+        {
+            // Degenerate face is never the closest
+            f.normal = {};
+            f.dist = kInf;
+        }
+    };
+
+    // Wind the tetrahedron so that normals face away from the opposite vertex
+    const auto flip = (((vertices[1].w - w0) ^ (vertices[2].w - w0)) | (vertices[3].w - w0)) > 0;
+    const size_t i1 = flip ? 2 : 1, i2 = flip ? 1 : 2;
+    AddFace(0, i1, i2);
+    AddFace(0, 3, i1);
+    AddFace(0, i2, 3);
+    AddFace(i1, 3, i2);
+
+    size_t closest = 0;
+    for (size_t iter = 0;; ++iter)
+    {
+        closest = 0;
+        for (size_t i = 1; i < num_faces; ++i)
+            if (faces[i].dist < faces[closest].dist)
+                closest = i;
+
+        const auto& face = faces[closest];
+        const auto vertex = GjkSupport(a, b, face.normal);
+        const auto dist = vertex.w | face.normal;
+        // Stop before the closest face is removed, so that it's the one reported. The horizon has at most one edge
+        // per vertex.
+        if (dist - face.dist <= tolerance * Max(Float(1), dist) || iter == max_iterations
+            || num_vertices == kMaxVertices || num_faces + num_vertices > kMaxFaces)
+            break;
+
+        // Remove faces the new vertex sees; the boundary of the hole is the horizon
+        uint8_t edges[kMaxFaces * 3][2];
+        size_t num_edges = 0;
+        for (size_t i = 0; i < num_faces;)
+        {
+            const auto& f = faces[i];
+            if ((f.normal | (vertex.w - vertices[f.v[0]].w)) <= 0)
+            {
+                ++i;
+                continue;
+            }
+
+            for (size_t e = 0; e < 3; ++e)
+            {
+                const uint8_t from = f.v[e], to = f.v[(e + 1) % 3];
+
+                // Shared with another removed face, so not on the horizon
+                const auto shared = std::find_if(edges, edges + num_edges,
+                                                 [&](const uint8_t* edge) { return edge[0] == to && edge[1] == from; });
+                if (shared != edges + num_edges)
+                {
+                    (*shared)[0] = edges[num_edges - 1][0];
+                    (*shared)[1] = edges[num_edges - 1][1];
+                    --num_edges;
+                }
+                else
+                {
+                    edges[num_edges][0] = from;
+                    edges[num_edges][1] = to;
+                    ++num_edges;
+                }
+            }
+            faces[i] = faces[--num_faces];
+        }
+
+        const auto index = num_vertices;
+        vertices[num_vertices++] = vertex;
+        for (size_t e = 0; e < num_edges; ++e)
+            AddFace(edges[e][0], edges[e][1], index);
+    }
+
+    // Origin projected onto the closest face, in barycentric coordinates of its vertices
+    const auto& face = faces[closest];
+    const auto& va = vertices[face.v[0]], & vb = vertices[face.v[1]], & vc = vertices[face.v[2]];
+    const auto p = face.normal * face.dist;
+    const auto n = (vb.w - va.w) ^ (vc.w - va.w);
+    const auto inv_area = 1 / n.LenSqr();
+    const auto u = (((vb.w - p) ^ (vc.w - p)) | n) * inv_area;
+    const auto v = (((vc.w - p) ^ (va.w - p)) | n) * inv_area;
+    const auto w = 1 - u - v;
+
+    return {face.normal, face.dist, va.a * u + vb.a * v + vc.a * w, va.b * u + vb.b * v + vc.b * w};
+}
+}
+
+/**
+ * \brief Penetration depth and direction of two overlapping convex shapes: GJK, then EPA.
+ * Depth of curved shapes is approximated by a polytope of at most 64 vertices.
+ * \param simplex Warm start for GJK, as in Gjk()
+ * \return Contact, or nullopt if the shapes don't overlap
+ */
+template <class A, class B>
+[[nodiscard]] std::optional<Contact> Penetration(const A& a, const B& b, GjkSimplex* simplex = nullptr,
+                                                 Float tolerance = kSmallNum, size_t max_iterations = 64)
+{
+    GjkSimplex local;
+    auto& s = simplex ? *simplex : local;
+    if (!Gjk(a, b, &s, tolerance, max_iterations).IsOverlapped())
+        return std::nullopt;
+    return detail::Epa(a, b, s, tolerance, max_iterations);
+}
+}
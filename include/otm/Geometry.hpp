@@ -8,6 +8,41 @@ struct Sphere
 {
     Vec3 pos;
     Float radius;
+
+    /**
+     * \brief Grow just enough to contain p, keeping the far side of the sphere in place
+     */
+    void Merge(const Vec3& p) noexcept
+    {
+        const auto dist_sqr = pos.DistSqr(p);
+        if (dist_sqr <= radius * radius)
+            return;
+
+        const auto dist = std::sqrt(dist_sqr);
+        const auto new_radius = (radius + dist) * Float(0.5);
+        pos += (p - pos) * ((new_radius - radius) / dist);
+        radius = new_radius;
+    }
+
+    /**
+     * \brief Smallest sphere containing both
+     */
+    void Merge(const Sphere& s) noexcept
+    {
+        const auto dist = pos.Dist(s.pos);
+        if (dist + s.radius <= radius)
+            return;
+
+        if (dist + radius <= s.radius)
+        {
+            *this = s;
+            return;
+        }
+
+        const auto new_radius = (dist + radius + s.radius) * Float(0.5);
+        pos += (s.pos - pos) * ((new_radius - radius) / dist);
+        radius = new_radius;
+    }
 };
 
 constexpr bool IsOverlapped(const Sphere& a, const Sphere& b) noexcept
@@ -156,4 +191,629 @@ static std::optional<Matrix<T, 4>> MakeLookAt(const Vector<T, 3>& eye,
         return std::nullopt;
     }
 }
+
+/**
+ * \brief Axis-aligned bounding box
+ */
+struct AABB
+{
+    Vec3 min;
+    Vec3 max;
+
+    [[nodiscard]] static constexpr AABB FromCenterExtent(const Vec3& center, const Vec3& extent) noexcept
+    {
+        return {center - extent, center + extent};
+    }
+
+    /**
+     * \brief Box containing nothing. Merging anything into it yields the bounds of that thing.
+     */
+    [[nodiscard]] static constexpr AABB Empty() noexcept
+    {
+        return {Vec3{All{}, kInf}, Vec3{All{}, -kInf}};
+    }
+
+    [[nodiscard]] constexpr Vec3 Center() const noexcept
+    {
+        return (min + max) * Float(0.5);
+    }
+
+    /**
+     * \brief Half size
+     */
+    [[nodiscard]] constexpr Vec3 Extent() const noexcept
+    {
+        return (max - min) * Float(0.5);
+    }
+
+    [[nodiscard]] constexpr Vec3 Size() const noexcept
+    {
+        return max - min;
+    }
+
+    [[nodiscard]] constexpr Float SurfaceArea() const noexcept
+    {
+        const auto d = max - min;
+        return 2 * (d[0] * d[1] + d[1] * d[2] + d[2] * d[0]);
+    }
+
+    [[nodiscard]] constexpr bool IsValid() const noexcept
+    {
+        return (min[0] <= max[0]) & (min[1] <= max[1]) & (min[2] <= max[2]);
+    }
+
+    [[nodiscard]] constexpr bool Contains(const Vec3& p) const noexcept
+    {
+        bool r = true;
+        for (size_t i = 0; i < 3; ++i)
+            r &= (min[i] <= p[i]) & (p[i] <= max[i]);
+        return r;
+    }
+
+    constexpr void Merge(const Vec3& p) noexcept
+    {
+        min = Min(min, p);
+        max = Max(max, p);
+    }
+
+    constexpr void Merge(const AABB& b) noexcept
+    {
+        min = Min(min, b.min);
+        max = Max(max, b.max);
+    }
+};
+
+/**
+ * \brief Oriented bounding box
+ */
+struct OBB
+{
+    Vec3 center;
+    Mat3 axes; // Rows are local X, Y, Z axes in world space. Must be orthonormal
+    Vec3 extent; // Half size along each axis
+
+    [[nodiscard]] static constexpr OBB FromRotation(const Vec3& center, const Quat& rot, const Vec3& extent) noexcept
+    {
+        return {center, MakeRotation(rot), extent};
+    }
+};
+
+/**
+ * \brief Half-infinite line. Distances along the ray are in units of dir, so dir need not be normalized.
+ */
+struct Ray
+{
+    Vec3 origin;
+    Vec3 dir;
+
+    [[nodiscard]] constexpr Vec3 At(Float t) const noexcept
+    {
+        return origin + dir * t;
+    }
+
+    /**
+     * \brief Reciprocal of dir. Zero components become infinity, which Raycast(Ray, Vec3, AABB) handles even when the
+     * origin lies on a face of the box.
+     */
+    [[nodiscard]] Vec3 InvDir() const noexcept
+    {
+        return {1 / dir[0], 1 / dir[1], 1 / dir[2]};
+    }
+};
+
+/**
+ * \brief Plane of points p where (normal | p) == d
+ */
+struct Plane
+{
+    Vec3 normal; // Must be normalized
+    Float d;
+
+    [[nodiscard]] static constexpr Plane FromPointNormal(const Vec3& p, const UVec3& normal) noexcept
+    {
+        return {*normal, *normal | p};
+    }
+
+    /**
+     * \brief Plane through three points. Normal faces the side from which a, b, c appear counter-clockwise
+     * \return Plane or nullopt if the points are collinear
+     */
+    [[nodiscard]] static std::optional<Plane> FromPoints(const Vec3& a, const Vec3& b, const Vec3& c) noexcept
+    {
+        if (const auto n = ((b - a) ^ (c - a)).Unit())
+            return FromPointNormal(a, *n);
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Signed distance. Positive on the side normal points to.
+     */
+    [[nodiscard]] constexpr Float Dist(const Vec3& p) const noexcept
+    {
+        return (normal | p) - d;
+    }
+};
+
+/**
+ * \brief Line segment [a, b]
+ */
+struct Segment
+{
+    Vec3 a;
+    Vec3 b;
+};
+
+/**
+ * \brief Sphere swept along segment [a, b]
+ */
+struct Capsule
+{
+    Vec3 a;
+    Vec3 b;
+    Float radius;
+};
+
+struct Triangle
+{
+    Vec3 a;
+    Vec3 b;
+    Vec3 c;
+
+    /**
+     * \brief Unnormalized normal. Faces the side from which a, b, c appear counter-clockwise. Length is twice the area.
+     */
+    [[nodiscard]] constexpr Vec3 Normal() const noexcept
+    {
+        return (b - a) ^ (c - a);
+    }
+};
+
+[[nodiscard]] constexpr AABB Bounds(const Sphere& s) noexcept
+{
+    return AABB::FromCenterExtent(s.pos, Vec3{All{}, s.radius});
+}
+
+[[nodiscard]] constexpr AABB Bounds(const OBB& b) noexcept
+{
+    // Projection of each rotated extent onto world axes
+    Vec3 ext;
+    for (size_t i = 0; i < 3; ++i)
+        ext += Abs(b.axes[i]) * b.extent[i];
+    return AABB::FromCenterExtent(b.center, ext);
+}
+
+[[nodiscard]] constexpr AABB Bounds(const Capsule& c) noexcept
+{
+    const Vec3 r{All{}, c.radius};
+    return {Min(c.a, c.b) - r, Max(c.a, c.b) + r};
+}
+
+[[nodiscard]] constexpr AABB Bounds(const Triangle& t) noexcept
+{
+    return {Min(Min(t.a, t.b), t.c), Max(Max(t.a, t.b), t.c)};
+}
+
+/**
+ * \brief Closest point on the segment to p
+ */
+[[nodiscard]] constexpr Vec3 ClosestPoint(const Segment& s, const Vec3& p) noexcept
+{
+    const auto ab = s.b - s.a;
+    const auto len_sqr = ab.LenSqr();
+    const auto t = len_sqr > 0 ? Clamp(((p - s.a) | ab) / len_sqr, Float(0), Float(1)) : Float(0);
+    return s.a + ab * t;
+}
+
+/**
+ * \brief Closest point on or in the box to p. p itself if it is inside.
+ */
+[[nodiscard]] constexpr Vec3 ClosestPoint(const AABB& b, const Vec3& p) noexcept
+{
+    return Clamp(p, b.min, b.max);
+}
+
+/**
+ * \brief Closest point on or in the box to p. p itself if it is inside.
+ */
+[[nodiscard]] constexpr Vec3 ClosestPoint(const OBB& b, const Vec3& p) noexcept
+{
+    const auto d = p - b.center;
+    auto q = b.center;
+    for (size_t i = 0; i < 3; ++i)
+        q += b.axes[i] * Clamp(d | b.axes[i], -b.extent[i], b.extent[i]);
+    return q;
+}
+
+/**
+ * \brief Closest point on the triangle to p, by Voronoi regions of its vertices, edges and face.
+ * Degenerate triangles give the closest point on their longest edge.
+ */
+[[nodiscard]] constexpr Vec3 ClosestPoint(const Triangle& tri, const Vec3& p) noexcept
+{
+    const auto ab = tri.b - tri.a, ac = tri.c - tri.a, ap = p - tri.a;
+    const auto d1 = ab | ap, d2 = ac | ap;
+    if (d1 <= 0 && d2 <= 0)
+        return tri.a;
+
+    const auto bp = p - tri.b;
+    const auto d3 = ab | bp, d4 = ac | bp;
+    if (d3 >= 0 && d4 <= d3)
+        return tri.b;
+
+    const auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        return tri.a + ab * (d1 / (d1 - d3));
+
+    const auto cp = p - tri.c;
+    const auto d5 = ab | cp, d6 = ac | cp;
+    if (d6 >= 0 && d5 <= d6)
+        return tri.c;
+
+    const auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        return tri.a + ac * (d2 / (d2 - d6));
+
+    const auto va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+        return tri.b + (tri.c - tri.b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    // Only a degenerate triangle has no face region left. Its longest edge covers it. The sum is the squared length
+    // of the normal, which rounding leaves slightly positive for some collinear triangles.
+    const auto sum = va + vb + vc;
+    if (sum <= kSmallNum * ab.LenSqr() * ac.LenSqr())
+    {
+        const auto ab_sqr = ab.LenSqr(), ac_sqr = ac.LenSqr(), bc_sqr = tri.b.DistSqr(tri.c);
+        if (ab_sqr >= ac_sqr && ab_sqr >= bc_sqr)
+            return ClosestPoint(Segment{tri.a, tri.b}, p);
+        return ClosestPoint(ac_sqr >= bc_sqr ? Segment{tri.a, tri.c} : Segment{tri.b, tri.c}, p);
+    }
+
+    return tri.a + ab * (vb / sum) + ac * (vc / sum);
+}
+
+/**
+ * \brief Closest pair of points between two segments. If the segments are parallel, any of the closest pairs.
+ * \return Point on s1 and point on s2
+ */
+[[nodiscard]] constexpr std::pair<Vec3, Vec3> ClosestPoints(const Segment& s1, const Segment& s2) noexcept
+{
+    const auto d1 = s1.b - s1.a, d2 = s2.b - s2.a, r = s1.a - s2.a;
+    const auto a = d1 | d1, e = d2 | d2, f = d2 | r;
+
+    if (a <= 0)
+        return {s1.a, ClosestPoint(s2, s1.a)};
+    if (e <= 0)
+        return {ClosestPoint(s1, s2.a), s2.a};
+
+    const auto b = d1 | d2, c = d1 | r;
+    const auto denom = a * e - b * b;
+
+    // Closest point on the first line to the second line, clamped to the segment. Any point will do if parallel.
+    auto s = denom > 0 ? Clamp((b * f - c * e) / denom, Float(0), Float(1)) : Float(0);
+    auto t = (b * s + f) / e;
+
+    // Clamp t and recompute s for it
+    if (t < 0)
+    {
+        t = 0;
+        s = Clamp(-c / a, Float(0), Float(1));
+    }
+    else if (t > 1)
+    {
+        t = 1;
+        s = Clamp((b - c) / a, Float(0), Float(1));
+    }
+
+    return {s1.a + d1 * s, s2.a + d2 * t};
+}
+
+[[nodiscard]] constexpr Float DistSqr(const Segment& s, const Vec3& p) noexcept
+{
+    return ClosestPoint(s, p).DistSqr(p);
+}
+
+/**
+ * \brief Zero if p is inside
+ */
+[[nodiscard]] constexpr Float DistSqr(const AABB& b, const Vec3& p) noexcept
+{
+    return ClosestPoint(b, p).DistSqr(p);
+}
+
+/**
+ * \brief Zero if p is inside
+ */
+[[nodiscard]] constexpr Float DistSqr(const OBB& b, const Vec3& p) noexcept
+{
+    return ClosestPoint(b, p).DistSqr(p);
+}
+
+[[nodiscard]] constexpr Float DistSqr(const Triangle& t, const Vec3& p) noexcept
+{
+    return ClosestPoint(t, p).DistSqr(p);
+}
+
+[[nodiscard]] constexpr Float DistSqr(const Segment& s1, const Segment& s2) noexcept
+{
+    const auto [p1, p2] = ClosestPoints(s1, s2);
+    return p1.DistSqr(p2);
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const AABB& a, const AABB& b) noexcept
+{
+    bool r = true;
+    for (size_t i = 0; i < 3; ++i)
+        r &= (a.min[i] <= b.max[i]) & (b.min[i] <= a.max[i]);
+    return r;
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const Sphere& s, const AABB& b) noexcept
+{
+    const auto closest = Clamp(s.pos, b.min, b.max);
+    return closest.DistSqr(s.pos) <= s.radius * s.radius;
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const AABB& b, const Sphere& s) noexcept
+{
+    return IsOverlapped(s, b);
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const Sphere& s, const Plane& p) noexcept
+{
+    return Abs(p.Dist(s.pos)) <= s.radius;
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const AABB& b, const Plane& p) noexcept
+{
+    const auto r = b.Extent() | Abs(p.normal);
+    return Abs(p.Dist(b.Center())) <= r;
+}
+
+/**
+ * \brief Separating axis test over the 15 candidate axes
+ */
+[[nodiscard]] constexpr bool IsOverlapped(const OBB& a, const OBB& b) noexcept
+{
+    // Rotation from b's frame to a's frame. Epsilon keeps near-parallel edge pairs from producing a false separating axis.
+    Mat3 rot, abs_rot;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+        {
+            rot[i][j] = a.axes[i] | b.axes[j];
+            abs_rot[i][j] = Abs(rot[i][j]) + kSmallNum;
+        }
+    }
+
+    const auto d = b.center - a.center;
+    const Vec3 t{d | a.axes[0], d | a.axes[1], d | a.axes[2]};
+
+    bool separated = false;
+
+    for (size_t i = 0; i < 3; ++i)
+        separated |= Abs(t[i]) > a.extent[i] + (b.extent | abs_rot[i]);
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+        const auto ra = a.extent[0] * abs_rot[0][j] + a.extent[1] * abs_rot[1][j] + a.extent[2] * abs_rot[2][j];
+        const auto dist = t[0] * rot[0][j] + t[1] * rot[1][j] + t[2] * rot[2][j];
+        separated |= Abs(dist) > ra + b.extent[j];
+    }
+
+    // a.axes[i] ^ b.axes[j]
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const auto i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            const auto j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            const auto ra = a.extent[i1] * abs_rot[i2][j] + a.extent[i2] * abs_rot[i1][j];
+            const auto rb = b.extent[j1] * abs_rot[i][j2] + b.extent[j2] * abs_rot[i][j1];
+            separated |= Abs(t[i2] * rot[i1][j] - t[i1] * rot[i2][j]) > ra + rb;
+        }
+    }
+
+    return !separated;
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const Sphere& s, const Capsule& c) noexcept
+{
+    const auto r = s.radius + c.radius;
+    return DistSqr(Segment{c.a, c.b}, s.pos) <= r * r;
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const Capsule& c, const Sphere& s) noexcept
+{
+    return IsOverlapped(s, c);
+}
+
+[[nodiscard]] constexpr bool IsOverlapped(const Capsule& a, const Capsule& b) noexcept
+{
+    const auto r = a.radius + b.radius;
+    return DistSqr(Segment{a.a, a.b}, Segment{b.a, b.b}) <= r * r;
+}
+
+/**
+ * \brief Slab test
+ * \param inv_dir ray.InvDir(). Precompute it when testing one ray against many boxes
+ * \return Distance to the entry point (0 if the origin is inside), or nullopt if the ray misses within [0, max_t]
+ */
+[[nodiscard]] inline std::optional<Float> Raycast(const Ray& ray, const Vec3& inv_dir, const AABB& box,
+                                                  Float max_t = kInf) noexcept
+{
+    auto t_near = Float(0), t_far = max_t;
+    for (auto i = 0; i < 3; ++i)
+    {
+        const auto t1 = (box.min[i] - ray.origin[i]) * inv_dir[i];
+        const auto t2 = (box.max[i] - ray.origin[i]) * inv_dir[i];
+
+        // A ray parallel to the slab with its origin on a face gives 0 * inf = NaN. It grazes the face, so the slab
+        // places no limit on t.
+        if (std::isnan(t1) || std::isnan(t2))
+            continue;
+
+        t_near = Max(t_near, Min(t1, t2));
+        t_far = Min(t_far, Max(t1, t2));
+    }
+    return t_near <= t_far ? std::optional{t_near} : std::nullopt;
+}
+
+[[nodiscard]] inline std::optional<Float> Raycast(const Ray& ray, const AABB& box, Float max_t = kInf) noexcept
+{
+    return Raycast(ray, ray.InvDir(), box, max_t);
+}
+
+/**
+ * \brief Möller–Trumbore ray-triangle intersection. Both sides of the triangle are hit.
+ * \return Distance to the hit point, or nullopt if the ray misses within [0, max_t]
+ */
+[[nodiscard]] constexpr std::optional<Float> Raycast(const Ray& ray, const Triangle& tri, Float max_t = kInf) noexcept
+{
+    const auto e1 = tri.b - tri.a, e2 = tri.c - tri.a;
+    const auto p = ray.dir ^ e2;
+    const auto det = e1 | p;
+    if (det == 0)
+        return std::nullopt;
+
+    const auto inv_det = 1 / det;
+    const auto s = ray.origin - tri.a;
+    const auto q = s ^ e1;
+    const auto u = (s | p) * inv_det;
+    const auto v = (ray.dir | q) * inv_det;
+    const auto t = (e2 | q) * inv_det;
+
+    const bool hit = (u >= 0) & (v >= 0) & (u + v <= 1) & (t >= 0) & (t <= max_t);
+    return hit ? std::optional{t} : std::nullopt;
+}
+
+/**
+ * \return Distance to the hit point, or nullopt if the ray is parallel to the plane or misses within [0, max_t]
+ */
+[[nodiscard]] constexpr std::optional<Float> Raycast(const Ray& ray, const Plane& plane, Float max_t = kInf) noexcept
+{
+    const auto denom = plane.normal | ray.dir;
+    if (denom == 0)
+        return std::nullopt;
+
+    const auto t = -plane.Dist(ray.origin) / denom;
+    return (t >= 0) & (t <= max_t) ? std::optional{t} : std::nullopt;
+}
+
+/**
+ * \return Distance to the entry point (0 if the origin is inside), or nullopt if the ray misses within [0, max_t]
+ */
+[[nodiscard]] inline std::optional<Float> Raycast(const Ray& ray, const Sphere& s, Float max_t = kInf) noexcept
+{
+    const auto m = ray.origin - s.pos;
+    const auto a = ray.dir | ray.dir;
+    const auto b = m | ray.dir;
+    const auto c = (m | m) - s.radius * s.radius;
+    const auto disc = b * b - a * c;
+    const auto sqrt_disc = std::sqrt(Max(disc, Float(0)));
+    const auto t_far = (-b + sqrt_disc) / a;
+    const auto t = Max((-b - sqrt_disc) / a, Float(0));
+
+    const bool hit = (disc >= 0) & (t_far >= 0) & (t <= max_t);
+    return hit ? std::optional{t} : std::nullopt;
+}
+
+/**
+ * \brief Ray against the cylindrical part, falling back to the end spheres if the hit is beyond either end
+ * \return Distance to the entry point (0 if the origin is inside), or nullopt if the ray misses within [0, max_t]
+ */
+[[nodiscard]] inline std::optional<Float> Raycast(const Ray& ray, const Capsule& c, Float max_t = kInf) noexcept
+{
+    const auto d = c.b - c.a, m = ray.origin - c.a;
+    const auto dd = d | d, md = m | d, nd = ray.dir | d;
+    const auto k = (m | m) - c.radius * c.radius;
+
+    // Quadratic for the infinite cylinder, scaled by dd
+    const auto qa = dd * (ray.dir | ray.dir) - nd * nd;
+    const auto qb = dd * (m | ray.dir) - nd * md;
+    const auto qc = dd * k - md * md;
+
+    if (dd > 0 && qc <= 0 && md >= 0 && md <= dd)
+        return Float(0);
+
+    if (dd > 0 && qa > 0)
+    {
+        const auto disc = qb * qb - qa * qc;
+        if (disc < 0)
+            return std::nullopt;
+
+        const auto t = (-qb - std::sqrt(disc)) / qa;
+        const auto s = md + t * nd;
+        if (qc > 0 && s >= 0 && s <= dd)
+            return (t >= 0) & (t <= max_t) ? std::optional{t} : std::nullopt;
+    }
+
+    const auto ta = Raycast(ray, Sphere{c.a, c.radius}, max_t);
+    const auto tb = Raycast(ray, Sphere{c.b, c.radius}, max_t);
+    if (ta && tb)
+        return Min(*ta, *tb);
+    return ta ? ta : tb;
+}
+
+/**
+ * \brief Six planes bounding the view volume. Normals face inward.
+ */
+struct Frustum
+{
+    enum Side
+    {
+        kLeft,
+        kRight,
+        kBottom,
+        kTop,
+        kNear,
+        kFar
+    };
+
+    Plane planes[6];
+
+    /**
+     * \brief Extract planes from view-projection matrix (Gribb-Hartmann)
+     * \param view_proj Row-vector view-projection matrix mapping depth to [0, 1], like MakePerspective() and MakeOrtho()
+     */
+    [[nodiscard]] static Frustum FromViewProj(const Mat4& view_proj) noexcept
+    {
+        // Each clip coordinate is a column of the matrix
+        const auto col = [&](size_t j) { return Vec4{view_proj[0][j], view_proj[1][j], view_proj[2][j], view_proj[3][j]}; };
+        const auto x = col(0), y = col(1), z = col(2), w = col(3);
+
+        const Vec4 coeffs[6]{w + x, w - x, w + y, w - y, z, w - z};
+
+        Frustum f;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            const Vec3 n{coeffs[i]};
+            const auto inv_len = 1 / n.Len();
+            f.planes[i] = {n * inv_len, -coeffs[i][3] * inv_len};
+        }
+        return f;
+    }
+};
+
+/**
+ * \return true if the sphere is at least partially inside the frustum
+ */
+[[nodiscard]] constexpr bool IsOverlapped(const Frustum& f, const Sphere& s) noexcept
+{
+    bool r = true;
+    for (const auto& p : f.planes)
+        r &= p.Dist(s.pos) >= -s.radius;
+    return r;
+}
+
+/**
+ * \return true if the box is at least partially inside the frustum. May return true for some boxes just outside the corners
+ */
+[[nodiscard]] constexpr bool IsOverlapped(const Frustum& f, const AABB& b) noexcept
+{
+    const auto c = b.Center(), e = b.Extent();
+    bool r = true;
+    for (const auto& p : f.planes)
+        r &= p.Dist(c) >= -(e | Abs(p.normal));
+    return r;
+}
 }
@@ -0,0 +1,404 @@
+#pragma once
+#include "Geometry.hpp"
+#include "SoA.hpp"
+#include <cstdint>
+
+/*
+ * Batched geometry queries over SoA containers, Pack::size elements at a time.
+ */
+
+namespace otm
+{
+/**
+ * \brief Structure-of-arrays container of segments. Stores the start and the direction b - a, which is what
+ * distance queries need.
+ */
+template <>
+class SoA<Segment>
+{
+public:
+    using value_type = Segment;
+    using size_type = size_t;
+    using Pack = SoA<Vec3>::Pack;
+
+    SoA() noexcept = default;
+
+    explicit SoA(size_t size)
+    {
+        Resize(size);
+    }
+
+    SoA(const Segment* segments, size_t count)
+        : SoA{count}
+    {
+        for (size_t i = 0; i < count; ++i)
+            Set(i, segments[i]);
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return a_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return a_.empty();
+    }
+
+    void Reserve(size_t capacity)
+    {
+        a_.Reserve(capacity);
+        d_.Reserve(capacity);
+    }
+
+    /**
+     * \brief Resize the container. New elements are points at the origin.
+     */
+    void Resize(size_t size)
+    {
+        a_.Resize(size);
+        d_.Resize(size);
+    }
+
+    void PushBack(const Segment& s)
+    {
+        a_.PushBack(s.a);
+        d_.PushBack(s.b - s.a);
+    }
+
+    void Clear() noexcept
+    {
+        a_.Clear();
+        d_.Clear();
+    }
+
+    [[nodiscard]] Segment operator[](size_t i) const noexcept
+    {
+        const auto a = a_[i];
+        return {a, a + d_[i]};
+    }
+
+    void Set(size_t i, const Segment& s) noexcept
+    {
+        a_.Set(i, s.a);
+        d_.Set(i, s.b - s.a);
+    }
+
+    /**
+     * \brief Start points
+     */
+    [[nodiscard]] const SoA<Vec3>& A() const noexcept
+    {
+        return a_;
+    }
+
+    /**
+     * \brief b - a of each segment
+     */
+    [[nodiscard]] const SoA<Vec3>& Dir() const noexcept
+    {
+        return d_;
+    }
+
+    [[nodiscard]] size_t PaddedSize() const noexcept
+    {
+        return a_.PaddedSize();
+    }
+
+private:
+    SoA<Vec3> a_, d_;
+};
+
+/**
+ * \brief Structure-of-arrays container of triangles. Stores the first vertex and the two edges from it,
+ * which is what the intersection test needs.
+ */
+template <>
+class SoA<Triangle>
+{
+public:
+    using value_type = Triangle;
+    using size_type = size_t;
+    using Pack = SoA<Vec3>::Pack;
+
+    SoA() noexcept = default;
+
+    explicit SoA(size_t size)
+    {
+        Resize(size);
+    }
+
+    SoA(const Triangle* triangles, size_t count)
+        : SoA{count}
+    {
+        for (size_t i = 0; i < count; ++i)
+            Set(i, triangles[i]);
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return a_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return a_.empty();
+    }
+
+    void Reserve(size_t capacity)
+    {
+        a_.Reserve(capacity);
+        e1_.Reserve(capacity);
+        e2_.Reserve(capacity);
+    }
+
+    /**
+     * \brief Resize the container. New elements are degenerate triangles at the origin, which are never hit.
+     */
+    void Resize(size_t size)
+    {
+        a_.Resize(size);
+        e1_.Resize(size);
+        e2_.Resize(size);
+    }
+
+    void PushBack(const Triangle& t)
+    {
+        a_.PushBack(t.a);
+        e1_.PushBack(t.b - t.a);
+        e2_.PushBack(t.c - t.a);
+    }
+
+    void Clear() noexcept
+    {
+        a_.Clear();
+        e1_.Clear();
+        e2_.Clear();
+    }
+
+    [[nodiscard]] Triangle operator[](size_t i) const noexcept
+    {
+        const auto a = a_[i];
+        return {a, a + e1_[i], a + e2_[i]};
+    }
+
+    void Set(size_t i, const Triangle& t) noexcept
+    {
+        a_.Set(i, t.a);
+        e1_.Set(i, t.b - t.a);
+        e2_.Set(i, t.c - t.a);
+    }
+
+    /**
+     * \brief First vertices
+     */
+    [[nodiscard]] const SoA<Vec3>& A() const noexcept
+    {
+        return a_;
+    }
+
+    /**
+     * \brief b - a of each triangle
+     */
+    [[nodiscard]] const SoA<Vec3>& Edge1() const noexcept
+    {
+        return e1_;
+    }
+
+    /**
+     * \brief c - a of each triangle
+     */
+    [[nodiscard]] const SoA<Vec3>& Edge2() const noexcept
+    {
+        return e2_;
+    }
+
+    [[nodiscard]] size_t PaddedSize() const noexcept
+    {
+        return a_.PaddedSize();
+    }
+
+private:
+    SoA<Vec3> a_, e1_, e2_;
+};
+
+namespace detail
+{
+template <class Pack>
+[[nodiscard]] Vector<Pack, 3> Broadcast(const Vec3& v) noexcept
+{
+    return {Pack::Set1(v[0]), Pack::Set1(v[1]), Pack::Set1(v[2])};
+}
+
+// Write out[i] for each element, per_pack(i) returning a pack of Pack::size results
+template <class Pack, class T, class Fn>
+void WritePacks(size_t size, T* out, Fn&& per_pack) noexcept
+{
+    size_t i = 0;
+    for (; i + Pack::size <= size; i += Pack::size)
+        per_pack(i).Store(out + i);
+
+    if (i < size)
+    {
+        T tail[Pack::size];
+        per_pack(i).Store(tail);
+        std::copy(tail, tail + (size - i), out + i);
+    }
+}
+
+// Squared distance from p to segments starting at a along d. Zero-length segments divide 0 by 0, and Max() with
+// the NaN first picks 0.
+template <class Pack>
+[[nodiscard]] Pack SegmentDistSqr(const Vector<Pack, 3>& a, const Vector<Pack, 3>& d, const Vector<Pack, 3>& p) noexcept
+{
+    const auto ap = p - a;
+    const auto t = Min(Max((ap | d) / (d | d), Pack::Set1(0)), Pack::Set1(1));
+    const auto r = ap - d * t;
+    return r | r;
+}
+
+// Set bit i of words[i / 64] for each element visible per per_pack(i), which returns a mask of Pack::size bits
+template <class Pack, class Fn>
+void WriteBitmask(size_t size, size_t padded_size, uint64_t* words, Fn&& per_pack) noexcept
+{
+    static_assert(64 % Pack::size == 0);
+    std::fill_n(words, (size + 63) / 64, uint64_t{0});
+    for (size_t i = 0; i < padded_size; i += Pack::size)
+        words[i / 64] |= uint64_t{per_pack(i)} << (i % 64);
+
+    // Padding is not part of the container
+    if (size % 64 != 0)
+        words[size / 64] &= (uint64_t{1} << (size % 64)) - 1;
+}
+}
+
+/**
+ * \brief Frustum-cull spheres, Pack::size at a time
+ * \param spheres Center in xyz, radius in w
+ * \param visible Bitmask of at least (spheres.size() + 63) / 64 words. Bit i of visible[i / 64] is set if
+ * i-th sphere is at least partially inside the frustum. Same as IsOverlapped(f, Sphere) for each sphere.
+ */
+inline void Cull(const Frustum& f, const SoA<Vector<Float, 4>>& spheres, uint64_t* visible) noexcept
+{
+    using Pack = SoA<Vector<Float, 4>>::Pack;
+
+    Vector<Pack, 4> planes[6];
+    for (size_t p = 0; p < 6; ++p)
+        for (size_t c = 0; c < 4; ++c)
+            planes[p][c] = Pack::Set1(c < 3 ? f.planes[p].normal[c] : f.planes[p].d);
+
+    const auto zero = Pack::Set1(0);
+    detail::WriteBitmask<Pack>(spheres.size(), spheres.PaddedSize(), visible, [&](size_t i)
+    {
+        const auto s = spheres.LoadPack(i);
+
+        // Minimum over planes of (signed distance + radius)
+        auto margin = Pack::Set1(kInf);
+        for (const auto& p : planes)
+            margin = Min(margin, MulAdd(p[0], s[0], MulAdd(p[1], s[1], MulAdd(p[2], s[2], s[3] - p[3]))));
+        return MaskGreaterEqual(margin, zero);
+    });
+}
+
+/**
+ * \brief Frustum-cull AABBs, Pack::size at a time
+ * \param mins, maxs Corners of boxes. Must be the same size
+ * \param visible Bitmask of at least (mins.size() + 63) / 64 words. Bit i of visible[i / 64] is set if
+ * i-th box is at least partially inside the frustum. Same as IsOverlapped(f, AABB) for each box.
+ */
+inline void Cull(const Frustum& f, const SoA<Vector<Float, 3>>& mins, const SoA<Vector<Float, 3>>& maxs,
+                 uint64_t* visible) noexcept
+{
+    using Pack = SoA<Vector<Float, 3>>::Pack;
+    assert(mins.size() == maxs.size());
+
+    Vector<Pack, 4> planes[6];
+    for (size_t p = 0; p < 6; ++p)
+        for (size_t c = 0; c < 4; ++c)
+            planes[p][c] = Pack::Set1(c < 3 ? f.planes[p].normal[c] : f.planes[p].d);
+
+    const auto zero = Pack::Set1(0);
+    detail::WriteBitmask<Pack>(mins.size(), mins.PaddedSize(), visible, [&](size_t i)
+    {
+        const auto lo = mins.LoadPack(i), hi = maxs.LoadPack(i);
+
+        // Test the corner furthest along each plane normal. The choice is the same for all lanes.
+        auto margin = Pack::Set1(kInf);
+        for (size_t p = 0; p < 6; ++p)
+        {
+            const auto& n = f.planes[p].normal;
+            const auto& x = n[0] >= 0 ? hi[0] : lo[0];
+            const auto& y = n[1] >= 0 ? hi[1] : lo[1];
+            const auto& z = n[2] >= 0 ? hi[2] : lo[2];
+            margin = Min(margin, MulAdd(planes[p][0], x, MulAdd(planes[p][1], y, MulAdd(planes[p][2], z, -planes[p][3]))));
+        }
+        return MaskGreaterEqual(margin, zero);
+    });
+}
+
+/**
+ * \brief out[i] = DistSqr(segments[i], p), Pack::size at a time
+ * \param out Array of at least segments.size() elements
+ */
+inline void DistSqr(const SoA<Segment>& segments, const Vec3& p, Float* out) noexcept
+{
+    using Pack = SoA<Segment>::Pack;
+    const auto q = detail::Broadcast<Pack>(p);
+    detail::WritePacks<Pack>(segments.size(), out, [&](size_t i)
+    {
+        return detail::SegmentDistSqr(segments.A().LoadPack(i), segments.Dir().LoadPack(i), q);
+    });
+}
+
+/**
+ * \brief out[i] = DistSqr(Triangle, p) for each triangle, Pack::size at a time.
+ * Inside the prism over the face the distance is to the plane, elsewhere to the nearest edge, so no lane branches.
+ * \param out Array of at least triangles.size() elements
+ */
+inline void DistSqr(const SoA<Triangle>& triangles, const Vec3& p, Float* out) noexcept
+{
+    using Pack = SoA<Triangle>::Pack;
+    const auto q = detail::Broadcast<Pack>(p);
+    const auto zero = Pack::Set1(0), minus_one = Pack::Set1(-1), small = Pack::Set1(kSmallNum);
+    detail::WritePacks<Pack>(triangles.size(), out, [&](size_t i)
+    {
+        const auto a = triangles.A().LoadPack(i), e1 = triangles.Edge1().LoadPack(i), e2 = triangles.Edge2().LoadPack(i);
+        const auto ap = q - a;
+        const auto n = e1 ^ e2;
+        const auto n_sqr = n | n;
+
+        // Negative if p is outside any edge. Slivers have no face to speak of, and a normal made of rounding error,
+        // so they count as outside.
+        const auto e3 = e2 - e1;
+        auto inside = Min(Min((e1 ^ ap) | n, (e3 ^ (ap - e1)) | n), (ap ^ e2) | n);
+        inside = SelectGreater(n_sqr, small * (e1 | e1) * (e2 | e2), inside, minus_one);
+
+        const auto plane = (ap | n) * (ap | n) / n_sqr;
+        const auto edge = Min(Min(detail::SegmentDistSqr(a, e1, q), detail::SegmentDistSqr(a, e2, q)),
+                              detail::SegmentDistSqr(a + e1, e3, q));
+        return SelectGreater(zero, inside, edge, plane);
+    });
+}
+
+/**
+ * \brief out[i] = DistSqr(AABB{mins[i], maxs[i]}, p), Pack::size at a time
+ * \param mins, maxs Corners of boxes. Must be the same size
+ * \param out Array of at least mins.size() elements
+ */
+inline void DistSqr(const SoA<Vec3>& mins, const SoA<Vec3>& maxs, const Vec3& p, Float* out) noexcept
+{
+    using Pack = SoA<Vec3>::Pack;
+    assert(mins.size() == maxs.size());
+
+    const auto q = detail::Broadcast<Pack>(p);
+    const auto zero = Pack::Set1(0);
+    detail::WritePacks<Pack>(mins.size(), out, [&](size_t i)
+    {
+        const auto lo = mins.LoadPack(i), hi = maxs.LoadPack(i);
+        Vector<Pack, 3> d;
+        for (size_t c = 0; c < 3; ++c)
+            d[c] = Max(Max(lo[c] - q[c], q[c] - hi[c]), zero);
+        return d | d;
+    });
+}
+}
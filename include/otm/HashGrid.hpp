@@ -0,0 +1,248 @@
+#pragma once
+#include "Vector.hpp"
+#include "Hash.hpp"
+#include <cmath>
+#include <vector>
+
+namespace otm
+{
+/**
+ * \brief Hash of integer grid cell. FNV over components, then folded so that low bits depend on all bits.
+ */
+[[nodiscard]] constexpr size_t HashCell(const Vec3i& cell) noexcept
+{
+    const auto h = HashRange(cell.begin(), cell.end(), [](int32_t x) { return static_cast<size_t>(static_cast<uint32_t>(x)); });
+    return h ^ (h >> (sizeof(size_t) * 4));
+}
+
+/**
+ * \brief Uniform grid of points hashed by cell, for neighbour queries.
+ * Each bucket is a doubly linked list threaded through flat per-item arrays, so inserting and moving items don't allocate
+ * (except when the bucket table grows). Items are referred to by the index Insert() returned, or their index in Build().
+ */
+class HashGrid
+{
+public:
+    /**
+     * \param cell_size Edge length of cells. Twice the usual query radius works well. Must be greater than zero
+     */
+    explicit HashGrid(Float cell_size) noexcept
+        : cell_size_{cell_size}, inv_cell_size_{1 / cell_size}
+    {
+        assert(cell_size > 0);
+    }
+
+    /**
+     * \brief Replace all items
+     */
+    void Build(const Vec3* positions, size_t count)
+    {
+        items_.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            items_[i] = {positions[i], Cell(positions[i]), kNone, kNone};
+
+        Rehash(BucketCountFor(count));
+    }
+
+    /**
+     * \return Index of inserted item
+     */
+    uint32_t Insert(const Vec3& p)
+    {
+        const auto i = static_cast<uint32_t>(items_.size());
+        items_.push_back({p, Cell(p), kNone, kNone});
+
+        if (items_.size() * 2 > head_.size())
+            Rehash(BucketCountFor(items_.size()));
+        else
+            Link(i);
+
+        return i;
+    }
+
+    /**
+     * \brief Update position of an item. Relinks it only if it moved to another cell.
+     */
+    void Move(uint32_t i, const Vec3& p) noexcept
+    {
+        assert(i < items_.size());
+        auto& item = items_[i];
+        item.position = p;
+
+        const auto cell = Cell(p);
+        if (cell == item.cell)
+            return;
+
+        Unlink(i);
+        item.cell = cell;
+        Link(i);
+    }
+
+    /**
+     * \brief Call fn(index) for each item within radius of center
+     */
+    template <class Fn>
+    void Query(const Vec3& center, Float radius, Fn&& fn) const
+    {
+        const auto radius_sqr = radius * radius;
+        ForEachCandidate(center, radius, [&](uint32_t i, const Item& item)
+        {
+            if (item.position.DistSqr(center) <= radius_sqr)
+                fn(i);
+        });
+    }
+
+    /**
+     * \brief Call fn(i, j) once for each pair of items within radius of each other, with i < j
+     */
+    template <class Fn>
+    void QueryPairs(Float radius, Fn&& fn) const
+    {
+        const auto radius_sqr = radius * radius;
+        // Bucket by bucket, so items sharing a cell visit the same neighbour cells back to back while they're cached
+        for (auto head : head_)
+        {
+            for (auto i = head; i != kNone; i = items_[i].next)
+            {
+                const auto p = items_[i].position;
+                ForEachCandidate(p, radius, [&](uint32_t j, const Item& item)
+                {
+                    if (i < j && item.position.DistSqr(p) <= radius_sqr)
+                        fn(i, j);
+                });
+            }
+        }
+    }
+
+    [[nodiscard]] Vec3i Cell(const Vec3& p) const noexcept
+    {
+        // Far coordinates share the outermost cells rather than overflow int32_t
+        Vec3i cell;
+        for (size_t k = 0; k < 3; ++k)
+            cell[k] = static_cast<int32_t>(Clamp(std::floor(p[k] * inv_cell_size_), -kMaxCell, kMaxCell));
+        return cell;
+    }
+
+    [[nodiscard]] const Vec3& Position(uint32_t i) const noexcept
+    {
+        assert(i < items_.size());
+        return items_[i].position;
+    }
+
+    [[nodiscard]] Float CellSize() const noexcept
+    {
+        return cell_size_;
+    }
+
+    /**
+     * \brief Number of items
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return items_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return items_.empty();
+    }
+
+private:
+    static constexpr uint32_t kNone = ~uint32_t{0};
+
+    // Far enough from the limits of int32_t that stepping one cell past it can't overflow
+    static constexpr int32_t kMaxCell = 1 << 30;
+
+    // Everything a bucket walk touches, kept together so each step is a single cache line
+    struct Item
+    {
+        Vec3 position;
+        Vec3i cell;
+        uint32_t next;
+        uint32_t prev;
+    };
+
+    [[nodiscard]] static size_t BucketCountFor(size_t count) noexcept
+    {
+        size_t n = 16;
+        while (n < count * 2)
+            n *= 2;
+        return n;
+    }
+
+    [[nodiscard]] size_t Bucket(const Vec3i& cell) const noexcept
+    {
+        return HashCell(cell) & (head_.size() - 1);
+    }
+
+    void Rehash(size_t bucket_count)
+    {
+        head_.assign(bucket_count, kNone);
+        for (uint32_t i = 0; i < items_.size(); ++i)
+            Link(i);
+    }
+
+    void Link(uint32_t i) noexcept
+    {
+        auto& item = items_[i];
+        auto& head = head_[Bucket(item.cell)];
+        item.prev = kNone;
+        item.next = head;
+        if (head != kNone)
+            items_[head].prev = i;
+        head = i;
+    }
+
+    void Unlink(uint32_t i) noexcept
+    {
+        const auto& item = items_[i];
+        if (item.prev != kNone)
+            items_[item.prev].next = item.next;
+        else
+            head_[Bucket(item.cell)] = item.next;
+
+        if (item.next != kNone)
+            items_[item.next].prev = item.prev;
+    }
+
+    // Items in cells overlapping the cube around center. Cells sharing a bucket are filtered out.
+    template <class Fn>
+    void ForEachCandidate(const Vec3& center, Float radius, Fn&& fn) const
+    {
+        if (items_.empty())
+            return;
+
+        const auto lo = Cell(center - Vec3{All{}, radius});
+        const auto hi = Cell(center + Vec3{All{}, radius});
+
+        // Walking more cells than there are items is slower than testing every item, and huge radii would walk billions
+        uint64_t cells = 1;
+        for (size_t k = 0; k < 3 && cells <= items_.size(); ++k)
+            cells *= static_cast<uint64_t>(int64_t{hi[k]} - lo[k] + 1);
+        if (cells > items_.size())
+        {
+            const auto InRange = [&](const Vec3i& c)
+            {
+                return lo[0] <= c[0] && c[0] <= hi[0] && lo[1] <= c[1] && c[1] <= hi[1] && lo[2] <= c[2] && c[2] <= hi[2];
+            };
+            for (uint32_t i = 0; i < items_.size(); ++i)
+                if (InRange(items_[i].cell))
+                    fn(i, items_[i]);
+            return;
+        }
+
+        Vec3i cell;
+        for (cell[2] = lo[2]; cell[2] <= hi[2]; ++cell[2])
+            for (cell[1] = lo[1]; cell[1] <= hi[1]; ++cell[1])
+                for (cell[0] = lo[0]; cell[0] <= hi[0]; ++cell[0])
+                    for (auto i = head_[Bucket(cell)]; i != kNone; i = items_[i].next)
+                        if (items_[i].cell == cell)
+                            fn(i, items_[i]);
+    }
+
+    Float cell_size_;
+    Float inv_cell_size_;
+    std::vector<Item> items_;
+    std::vector<uint32_t> head_; // First item of each bucket
+};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Vector.hpp"
+#include <cstdint>
+#include <utility>
 
 namespace otm
 {
@@ -281,9 +283,21 @@ struct Matrix : detail::MatrixBase<T, R, C>
     constexpr Matrix<std::common_type_t<T, T2>, R, C2> operator*(const Matrix<T2, C, C2>& b) const noexcept
     {
         Matrix<std::common_type_t<T, T2>, R, C2> c;
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, C2> && std::is_same_v<T, T2>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdMulMat<R, C, C2>(AsFlatArr(), b.AsFlatArr(), c.AsFlatArr());
+                return c;
+            }
+        }
+#endif
+        // Accumulate rows of b instead of gathering its columns
         for (size_t i = 0; i < R; ++i)
-            for (size_t j = 0; j < C2; ++j)
-                c[i][j] = Row(i) | b.Col(j);
+            for (size_t k = 0; k < C; ++k)
+                for (size_t j = 0; j < C2; ++j)
+                    c[i][j] += arr[i][k] * b[k][j];
         return c;
     }
 
@@ -301,51 +315,192 @@ struct Matrix : detail::MatrixBase<T, R, C>
         return t;
     }
 
+    /**
+     * \brief Determinant. Closed form up to 4x4, elimination for larger matrices
+     */
     [[nodiscard]] constexpr T Det() const noexcept
     {
         static_assert(R == C);
 
+        const auto& a = arr;
         if constexpr (R == 1)
         {
-            return arr[0][0];
+            return a[0][0];
         }
-        else
+        else if constexpr (R == 2)
         {
-            auto plus = true;
-            T det = 0;
-            for (size_t i = 0; i < R; ++i)
+            return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        }
+        else if constexpr (R == 3)
+        {
+            return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+        }
+        else if constexpr (R == 4)
+        {
+            const auto [s, c] = SubDets();
+            return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            // LU decomposition with partial pivoting
+            auto m = *this;
+            T det = 1;
+            for (size_t k = 0; k < R; ++k)
             {
-                const auto x = arr[i][R - 1] * Slice(i, R - 1).Det();
-                if (plus)
-                    det += x;
-                else
-                    det -= x;
-                plus = !plus;
+                const auto p = Pivot(m, k);
+                if (m[p][k] == 0)
+                    return 0;
+                if (p != k)
+                {
+                    SwapRows(m, p, k);
+                    det = -det;
+                }
+                det *= m[k][k];
+                for (size_t i = k + 1; i < R; ++i)
+                    m[i] -= m[k] * (m[i][k] / m[k][k]);
             }
             return det;
         }
+        else
+        {
+            // Fraction-free (Bareiss) elimination keeps integer determinants exact
+            auto m = *this;
+            T prev = 1;
+            auto negate = false;
+            for (size_t k = 0; k + 1 < R; ++k)
+            {
+                if (m[k][k] == 0)
+                {
+                    auto p = k + 1;
+                    while (p < R && m[p][k] == 0)
+                        ++p;
+                    if (p == R)
+                        return 0;
+                    SwapRows(m, p, k);
+                    negate = !negate;
+                }
+                for (size_t i = k + 1; i < R; ++i)
+                    for (size_t j = k + 1; j < R; ++j)
+                        m[i][j] = (m[i][j] * m[k][k] - m[i][k] * m[k][j]) / prev;
+                prev = m[k][k];
+            }
+            return negate ? -m[R - 1][R - 1] : m[R - 1][R - 1];
+        }
     }
 
+    /**
+     * \brief Inverse matrix. Closed form up to 4x4, Gauss-Jordan elimination with partial pivoting for larger matrices
+     * \return Inverse matrix or nullopt if IsNearlyZero(Det())
+     */
     [[nodiscard]] constexpr std::optional<Matrix> Inv() const noexcept
     {
         static_assert(R == C);
         static_assert(std::is_floating_point_v<T>);
 
-        const auto det = Det();
-        if (IsNearlyZero(det))
-            return {};
-
-        Matrix inv;
-        for (size_t i = 0; i < R; ++i)
+        const auto& a = arr;
+        if constexpr (R == 1)
+        {
+            if (IsNearlyZero(a[0][0]))
+                return {};
+            return Matrix{1 / a[0][0]};
+        }
+        else if constexpr (R == 2)
+        {
+            const auto det = Det();
+            if (IsNearlyZero(det))
+                return {};
+            const auto inv_det = 1 / det;
+            return Matrix{
+                a[1][1] * inv_det, -a[0][1] * inv_det,
+                -a[1][0] * inv_det, a[0][0] * inv_det
+            };
+        }
+        else if constexpr (R == 3)
+        {
+            const auto c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+            const auto c10 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+            const auto c20 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+            const auto det = a[0][0] * c00 + a[0][1] * c10 + a[0][2] * c20;
+            if (IsNearlyZero(det))
+                return {};
+            const auto inv_det = 1 / det;
+            return Matrix{
+                c00 * inv_det,
+                (a[0][2] * a[2][1] - a[0][1] * a[2][2]) * inv_det,
+                (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * inv_det,
+                c10 * inv_det,
+                (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * inv_det,
+                (a[0][2] * a[1][0] - a[0][0] * a[1][2]) * inv_det,
+                c20 * inv_det,
+                (a[0][1] * a[2][0] - a[0][0] * a[2][1]) * inv_det,
+                (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * inv_det
+            };
+        }
+        else if constexpr (R == 4)
         {
-            for (size_t j = 0; j < C; ++j)
+            const auto [s, c] = SubDets();
+            const auto det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            if (IsNearlyZero(det))
+                return {};
+            const auto inv_det = 1 / det;
+            return Matrix{
+                (a[1][1] * c[5] - a[1][2] * c[4] + a[1][3] * c[3]) * inv_det,
+                (-a[0][1] * c[5] + a[0][2] * c[4] - a[0][3] * c[3]) * inv_det,
+                (a[3][1] * s[5] - a[3][2] * s[4] + a[3][3] * s[3]) * inv_det,
+                (-a[2][1] * s[5] + a[2][2] * s[4] - a[2][3] * s[3]) * inv_det,
+
+                (-a[1][0] * c[5] + a[1][2] * c[2] - a[1][3] * c[1]) * inv_det,
+                (a[0][0] * c[5] - a[0][2] * c[2] + a[0][3] * c[1]) * inv_det,
+                (-a[3][0] * s[5] + a[3][2] * s[2] - a[3][3] * s[1]) * inv_det,
+                (a[2][0] * s[5] - a[2][2] * s[2] + a[2][3] * s[1]) * inv_det,
+
+                (a[1][0] * c[4] - a[1][1] * c[2] + a[1][3] * c[0]) * inv_det,
+                (-a[0][0] * c[4] + a[0][1] * c[2] - a[0][3] * c[0]) * inv_det,
+                (a[3][0] * s[4] - a[3][1] * s[2] + a[3][3] * s[0]) * inv_det,
+                (-a[2][0] * s[4] + a[2][1] * s[2] - a[2][3] * s[0]) * inv_det,
+
+                (-a[1][0] * c[3] + a[1][1] * c[1] - a[1][2] * c[0]) * inv_det,
+                (a[0][0] * c[3] - a[0][1] * c[1] + a[0][2] * c[0]) * inv_det,
+                (-a[3][0] * s[3] + a[3][1] * s[1] - a[3][2] * s[0]) * inv_det,
+                (a[2][0] * s[3] - a[2][1] * s[1] + a[2][2] * s[0]) * inv_det
+            };
+        }
+        else
+        {
+            auto m = *this;
+            auto inv = Matrix::Identity();
+            T det = 1;
+            for (size_t k = 0; k < R; ++k)
             {
-                inv[i][j] = Slice(j, i).Det() / det;
-                if ((i + j) % 2 == 0)
-                    inv[i][j] = -inv[i][j];
+                const auto p = Pivot(m, k);
+                if (m[p][k] == 0)
+                    return {};
+                if (p != k)
+                {
+                    SwapRows(m, p, k);
+                    SwapRows(inv, p, k);
+                    det = -det;
+                }
+                det *= m[k][k];
+
+                const auto f = 1 / m[k][k];
+                m[k] *= f;
+                inv[k] *= f;
+                for (size_t i = 0; i < R; ++i)
+                {
+                    if (i == k)
+                        continue;
+                    const auto x = m[i][k];
+                    m[i] -= m[k] * x;
+                    inv[i] -= inv[k] * x;
+                }
             }
+            if (IsNearlyZero(det))
+                return {};
+            return inv;
         }
-        return inv;
     }
 
     [[nodiscard]] constexpr Matrix<T, R - 1, C - 1> Slice(const size_t y, const size_t x) const noexcept
@@ -437,6 +592,49 @@ private:
         throw std::out_of_range{"Matrix out of range"};
     }
 
+    /**
+     * \brief 2x2 sub-determinants of the upper (first) and lower (second) two rows of 4x4 matrix
+     */
+    [[nodiscard]] constexpr std::pair<Vector<T, 6>, Vector<T, 6>> SubDets() const noexcept
+    {
+        const auto& a = arr;
+        return {
+            {
+                a[0][0] * a[1][1] - a[1][0] * a[0][1],
+                a[0][0] * a[1][2] - a[1][0] * a[0][2],
+                a[0][0] * a[1][3] - a[1][0] * a[0][3],
+                a[0][1] * a[1][2] - a[1][1] * a[0][2],
+                a[0][1] * a[1][3] - a[1][1] * a[0][3],
+                a[0][2] * a[1][3] - a[1][2] * a[0][3]
+            },
+            {
+                a[2][0] * a[3][1] - a[3][0] * a[2][1],
+                a[2][0] * a[3][2] - a[3][0] * a[2][2],
+                a[2][0] * a[3][3] - a[3][0] * a[2][3],
+                a[2][1] * a[3][2] - a[3][1] * a[2][2],
+                a[2][1] * a[3][3] - a[3][1] * a[2][3],
+                a[2][2] * a[3][3] - a[3][2] * a[2][3]
+            }
+        };
+    }
+
+    // Row index of the largest absolute value in column k, from row k
+    [[nodiscard]] static constexpr size_t Pivot(const Matrix& m, size_t k) noexcept
+    {
+        auto p = k;
+        for (auto i = k + 1; i < R; ++i)
+            if (Abs(m[i][k]) > Abs(m[p][k]))
+                p = i;
+        return p;
+    }
+
+    static constexpr void SwapRows(Matrix& m, size_t i, size_t j) noexcept
+    {
+        const auto t = m[i];
+        m[i] = m[j];
+        m[j] = t;
+    }
+
     Vector<T, C> arr[R];
 };
 
@@ -446,6 +644,278 @@ constexpr auto operator*(F f, const Matrix<T, R, C>& m) noexcept
     return m * f;
 }
 
+/**
+ * \brief Multiply row vector by matrix
+ */
+template <class T, class U, size_t R, size_t C>
+constexpr Vector<std::common_type_t<T, U>, C> operator*(const Vector<T, R>& v, const Matrix<U, R, C>& m) noexcept
+{
+    Vector<std::common_type_t<T, U>, C> r;
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, C> && std::is_same_v<T, U>)
+    {
+        if (!detail::IsConstantEvaluated())
+        {
+            detail::SimdStore<C>(r.data, detail::SimdMulRow<R, C>(v.data, m.AsFlatArr()));
+            return r;
+        }
+    }
+#endif
+    for (size_t k = 0; k < R; ++k)
+        for (size_t j = 0; j < C; ++j)
+            r[j] += v[k] * m[k][j];
+    return r;
+}
+
+/**
+ * \brief Transform point by affine matrix. Same as Vector{p, 1} * m without perspective division
+ * \param m 4x4 matrix or 4x3 affine matrix
+ */
+template <class T, size_t C>
+constexpr Vector<T, 3> TransformPoint(const Vector<T, 3>& p, const Matrix<T, 4, C>& m) noexcept
+{
+    static_assert(C == 3 || C == 4);
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, C>)
+    {
+        if (!detail::IsConstantEvaluated())
+        {
+            const auto acc = _mm_add_ps(detail::SimdMulRow<3, C>(p.data, m.AsFlatArr()), detail::SimdLoad<C>(m[3].data));
+            Vector<T, 3> r;
+            detail::SimdStore<3>(r.data, acc);
+            return r;
+        }
+    }
+#endif
+    Vector<T, 3> r{m[3]};
+    for (size_t k = 0; k < 3; ++k)
+        for (size_t j = 0; j < 3; ++j)
+            r[j] += p[k] * m[k][j];
+    return r;
+}
+
+/**
+ * \brief Transform direction by affine matrix. Same as Vector{v, 0} * m, translation is ignored
+ * \param m 4x4 matrix or 4x3 affine matrix
+ */
+template <class T, size_t C>
+constexpr Vector<T, 3> TransformDirection(const Vector<T, 3>& v, const Matrix<T, 4, C>& m) noexcept
+{
+    static_assert(C == 3 || C == 4);
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, C>)
+    {
+        if (!detail::IsConstantEvaluated())
+        {
+            Vector<T, 3> r;
+            detail::SimdStore<3>(r.data, detail::SimdMulRow<3, C>(v.data, m.AsFlatArr()));
+            return r;
+        }
+    }
+#endif
+    Vector<T, 3> r;
+    for (size_t k = 0; k < 3; ++k)
+        for (size_t j = 0; j < 3; ++j)
+            r[j] += v[k] * m[k][j];
+    return r;
+}
+
+namespace detail
+{
+template <class T, size_t C>
+void TransformVec3s(const Vector<T, 3>* in, Vector<T, 3>* out, size_t count, const Matrix<T, 4, C>& m,
+                    bool translate) noexcept
+{
+    static_assert(C == 3 || C == 4);
+
+    size_t i = 0;
+#if OTM_SIMD_SSE
+    if constexpr (kSimdVec<T, 3>)
+    {
+        const auto stream = count * sizeof(Vector<T, 3>) >= kNonTemporalThreshold;
+        if (stream)
+        {
+            // Non-temporal stores need 16-byte alignment; every 4th Vec3 has the same alignment
+            for (; i < count && reinterpret_cast<uintptr_t>(out + i) % 16 != 0; ++i)
+                out[i] = translate ? TransformPoint(in[i], m) : TransformDirection(in[i], m);
+        }
+
+        __m128 r[3][3], t[3];
+        for (size_t k = 0; k < 3; ++k)
+        {
+            for (size_t j = 0; j < 3; ++j)
+                r[k][j] = _mm_set1_ps(m[k][j]);
+            t[k] = _mm_set1_ps(translate ? m[3][k] : 0);
+        }
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x, y, z;
+            SimdLoadSoA3(in[i].data, x, y, z);
+            __m128 o[3];
+            for (size_t j = 0; j < 3; ++j)
+                o[j] = SimdMulAdd(x, r[0][j], SimdMulAdd(y, r[1][j], SimdMulAdd(z, r[2][j], t[j])));
+            SimdStoreSoA3(out[i].data, o[0], o[1], o[2], stream);
+        }
+
+        if (stream)
+            _mm_sfence();
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = translate ? TransformPoint(in[i], m) : TransformDirection(in[i], m);
+}
+}
+
+/**
+ * \brief Transform array of points. Same as out[i] = TransformPoint(in[i], m)
+ * \param in Input points
+ * \param out Output points. May be the same as in
+ * \param count Number of points
+ * \param m 4x4 matrix or 4x3 affine matrix
+ */
+template <class T, size_t C>
+void TransformPoints(const Vector<T, 3>* in, Vector<T, 3>* out, size_t count, const Matrix<T, 4, C>& m) noexcept
+{
+    detail::TransformVec3s(in, out, count, m, true);
+}
+
+/**
+ * \brief Transform array of directions. Same as out[i] = TransformDirection(in[i], m)
+ * \param in Input directions
+ * \param out Output directions. May be the same as in
+ * \param count Number of directions
+ * \param m 4x4 matrix or 4x3 affine matrix
+ */
+template <class T, size_t C>
+void TransformDirections(const Vector<T, 3>* in, Vector<T, 3>* out, size_t count, const Matrix<T, 4, C>& m) noexcept
+{
+    detail::TransformVec3s(in, out, count, m, false);
+}
+
+/**
+ * \brief Transform array of homogeneous vectors. Same as out[i] = in[i] * m
+ * \param in Input vectors
+ * \param out Output vectors. May be the same as in
+ * \param count Number of vectors
+ */
+template <class T>
+void TransformVectors(const Vector<T, 4>* in, Vector<T, 4>* out, size_t count, const Matrix<T, 4>& m) noexcept
+{
+    size_t i = 0;
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, 4>)
+    {
+        const auto stream = count * sizeof(Vector<T, 4>) >= detail::kNonTemporalThreshold &&
+                            reinterpret_cast<uintptr_t>(out) % 16 == 0;
+        const auto r0 = _mm_loadu_ps(m[0].data), r1 = _mm_loadu_ps(m[1].data);
+        const auto r2 = _mm_loadu_ps(m[2].data), r3 = _mm_loadu_ps(m[3].data);
+        for (; i < count; ++i)
+        {
+            const auto v = _mm_loadu_ps(in[i].data);
+            auto acc = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+            acc = detail::SimdMulAdd(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r1, acc);
+            acc = detail::SimdMulAdd(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r2, acc);
+            acc = detail::SimdMulAdd(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r3, acc);
+            if (stream)
+                _mm_stream_ps(out[i].data, acc);
+            else
+                _mm_storeu_ps(out[i].data, acc);
+        }
+
+        if (stream)
+            _mm_sfence();
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = in[i] * m;
+}
+
+/*
+ * Affine matrices are stored as Matrix<T, 4, 3>: the upper 3x3 is the linear part and the last row is the translation.
+ * They work like 4x4 matrices whose last column is (0, 0, 0, 1).
+ * Use Matrix<T, 4>::Identity(affine) to expand and Matrix<T, 4, 3>{mat4} to truncate.
+ */
+
+/**
+ * \brief Multiply affine matrices. Same as 4x4 multiplication but with 36 multiplications instead of 64
+ */
+template <class T>
+constexpr Matrix<T, 4, 3> MulAffine(const Matrix<T, 4, 3>& a, const Matrix<T, 4, 3>& b) noexcept
+{
+    Matrix<T, 4, 3> c;
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, 3>)
+    {
+        if (!detail::IsConstantEvaluated())
+        {
+            // A 4x3 matrix is 4 packed Vector<float, 3>, so the transposing loads give the columns of a.
+            // Column j of c is a's columns weighted by column j of b, where a's implicit fourth column is (0, 0, 0, 1).
+            __m128 x, y, z;
+            detail::SimdLoadSoA3(a.AsFlatArr(), x, y, z);
+            const auto w = _mm_set_ps(1, 0, 0, 0);
+            const auto* pb = b.AsFlatArr();
+            const auto Column = [&](size_t j)
+            {
+                auto acc = _mm_mul_ps(x, _mm_set1_ps(pb[j]));
+                acc = detail::SimdMulAdd(y, _mm_set1_ps(pb[3 + j]), acc);
+                acc = detail::SimdMulAdd(z, _mm_set1_ps(pb[6 + j]), acc);
+                return detail::SimdMulAdd(w, _mm_set1_ps(pb[9 + j]), acc);
+            };
+            detail::SimdStoreSoA3(c.AsFlatArr(), Column(0), Column(1), Column(2));
+            return c;
+        }
+    }
+#endif
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t j = 0; j < 3; ++j)
+                c[i][j] += a[i][k] * b[k][j];
+    c[3] += b[3];
+    return c;
+}
+
+/**
+ * \brief Inverse of affine matrix
+ * \return Inverse matrix or nullopt if the linear part is singular
+ */
+template <class T>
+constexpr std::optional<Matrix<T, 4, 3>> InvAffine(const Matrix<T, 4, 3>& m) noexcept
+{
+    const auto l = Matrix<T, 3>{m}.Inv();
+    if (!l)
+        return {};
+
+    Matrix<T, 4, 3> inv{*l};
+    inv[3] = -(m[3] * *l);
+    return inv;
+}
+
+/**
+ * \brief Inverse of affine matrix without shear, i.e. made of rotation, scale and translation only.
+ * The linear part is inverted by transposing the rotation and taking reciprocal of the scale.
+ * \return Inverse matrix or nullopt if any scale is nearly zero
+ */
+template <class T>
+constexpr std::optional<Matrix<T, 4, 3>> InvAffineNoShear(const Matrix<T, 4, 3>& m) noexcept
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    Matrix<T, 4, 3> inv;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        // Row i is (rotation row i) * scale[i], so its squared length is scale[i]^2
+        const auto scale_sqr = m[i].LenSqr();
+        if (IsNearlyZero(scale_sqr))
+            return {};
+        const auto row = m[i] / scale_sqr;
+        for (size_t j = 0; j < 3; ++j)
+            inv[j][i] = row[j];
+    }
+    inv[3] = -TransformDirection(m[3], inv);
+    return inv;
+}
+
 template <class T, size_t R, size_t C>
 std::ostream& operator<<(std::ostream& os, const Matrix<T, R, C>& m)
 {
@@ -1,8 +1,26 @@
 #pragma once
-#include "Matrix.hpp"
+#include "SoA.hpp"
+#include <limits>
 
 namespace otm
 {
+	/**
+	 * \brief Order of the rotations about each axis, about the fixed axes: kXYZ rotates about X first, then Y, then Z.
+	 * About the rotating axes instead, the order reverses: kXYZ is also Z first, then the new Y, then the new X.
+	 */
+	enum class EulerOrder { kXYZ, kXZY, kYXZ, kYZX, kZXY, kZYX };
+
+	/**
+	 * \brief Rotation angle about each axis. With Forward on X and Up on Z, these are roll, pitch and yaw.
+	 */
+	template <class T>
+	struct EulerAngles
+	{
+		Angle<RadR, T> x; // About Forward: roll
+		Angle<RadR, T> y; // About Right: pitch
+		Angle<RadR, T> z; // About Up: yaw
+	};
+
 	template <class T>
 	struct Quaternion
 	{
@@ -13,54 +31,56 @@ namespace otm
 		[[nodiscard]] static constexpr Quaternion Identity() noexcept { return {}; }
 		[[nodiscard]] static Quaternion Rand() noexcept { return {UVec3::Rand(), Rad::Rand()}; }
 
+		[[nodiscard]] static Quaternion FromEuler(const EulerAngles<T>& angles, EulerOrder order = EulerOrder::kXYZ) noexcept;
+
+		/**
+		 * \brief Shortest arc rotation that takes from to to. If they are opposite, a half turn about any
+		 * axis perpendicular to them.
+		 */
+		[[nodiscard]] static Quaternion FromTo(const UnitVec<T, 3>& from, const UnitVec<T, 3>& to) noexcept;
+
+		/**
+		 * \brief Rotation that turns Forward to forward and Up to as close to up as possible, keeping the horizon level.
+		 * If up is parallel to forward, the roll about forward is arbitrary.
+		 */
+		[[nodiscard]] static Quaternion LookRotation(const UnitVec<T, 3>& forward,
+			const UnitVec<T, 3>& up = UnitVec<T, 3>::Up()) noexcept;
+
+		/**
+		 * \brief Rotation that turns Forward, Right and Up to the given orthonormal axes: the rows of its matrix.
+		 */
+		[[nodiscard]] static Quaternion FromAxes(const Vector<T, 3>& x, const Vector<T, 3>& y,
+			const Vector<T, 3>& z) noexcept;
+
 		Vector<T, 3> v;
 		T s = 1;
 
 		constexpr Quaternion() noexcept = default;
 		constexpr Quaternion(const Vector<T, 3>& v, T s) noexcept: v{v}, s{s} {}
 		constexpr Quaternion(T x, T y, T z, T w) noexcept: v{x, y, z}, s{w} {}
-		explicit constexpr Quaternion(const Vector<T, 4>& v4) noexcept: v{v4}, s{v4.w} {}
+		explicit constexpr Quaternion(const Vector<T, 4>& v4) noexcept: v{v4}, s{v4[3]} {}
 		
 		Quaternion(const UnitVec<T, 3>& axis, Angle<RadR, T> angle) noexcept
 			:Quaternion{axis.Get() * Sin(angle / 2), Cos(angle / 2)}
 		{
 		}
 
-		explicit Quaternion(const Mat3& m) noexcept
-		{
-			if (const auto trace = m[0][0] + m[1][1] + m[2][2]; trace > 0)
-			{
-				const auto t = 0.5_f / std::sqrt(trace + 1);
-				v[0] = (m[1][2] - m[2][1]) * t;
-				v[1] = (m[2][0] - m[0][2]) * t;
-				v[2] = (m[0][1] - m[1][0]) * t;
-				s = 0.25_f / t;
-			}
-			else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
-			{
-				const auto t = 2 * std::sqrt(1 + m[0][0] - m[1][1] - m[2][2]);
-				v[0] = 0.25_f * t;
-				v[1] = (m[0][1] + m[1][0]) / t;
-				v[2] = (m[0][2] + m[2][0]) / t;
-				s = (m[1][2] - m[2][1]) / t;
-			}
-			else if (m[1][1] > m[2][2])
-			{
-				const auto t = 2 * std::sqrt(1 + m[1][1] - m[0][0] - m[2][2]);
-				v[0] = (m[0][1] + m[1][0]) / t;
-				v[1] = 0.25_f * t;
-				v[2] = (m[1][2] + m[2][1] ) / t;
-				s = (m[2][0] - m[0][2]) / t;
-			}
-			else
-			{
-				const auto t = 2 * std::sqrt(1 + m[2][2] - m[0][0] - m[1][1]);
-				v[0] = (m[0][2] + m[2][0]) / t;
-				v[1] = (m[1][2] + m[2][1]) / t;
-				v[2] = 0.25_f * t;
-				s = (m[0][1] - m[1][0]) / t;
-			}
-		}
+		explicit Quaternion(const Mat3& m) noexcept: Quaternion{FromAxes(m[0], m[1], m[2])} {}
+
+		/**
+		 * \brief Angles such that FromEuler(ToEuler(order), order) is this rotation. The middle angle in order is
+		 * in [-90, 90] degrees, the others in [-180, 180]. At the middle angle's ends, where the other two rotate
+		 * about the same axis (gimbal lock), the last angle is 0. Must be normalized.
+		 */
+		[[nodiscard]] EulerAngles<T> ToEuler(EulerOrder order = EulerOrder::kXYZ) const noexcept;
+
+		/**
+		 * \brief Split into a twist about axis and a swing about an axis perpendicular to it, with
+		 * *this == swing * twist: twist applied first. Twist is the identity if the rotation has no component
+		 * about axis. Must be normalized.
+		 * \return {swing, twist}
+		 */
+		[[nodiscard]] std::pair<Quaternion, Quaternion> SwingTwist(const UnitVec<T, 3>& axis) const noexcept;
 
 		constexpr void Invert() noexcept { Conjugate(); *this /= LenSqr(); }
 		constexpr void Conjugate() noexcept { v.Negate(); }
@@ -70,6 +90,10 @@ namespace otm
 		
 		constexpr Quaternion operator~() const noexcept { return **this / LenSqr(); }
 		constexpr Quaternion operator*() const noexcept { return {-v, s}; }
+		constexpr Quaternion operator-() const noexcept { return {-v, -s}; }
+		constexpr Quaternion operator+(const Quaternion& q) const noexcept { return {v + q.v, s + q.s}; }
+		constexpr Quaternion operator-(const Quaternion& q) const noexcept { return {v - q.v, s - q.s}; }
+		constexpr T operator|(const Quaternion& q) const noexcept { return (v | q.v) + s*q.s; }
 		constexpr Quaternion operator*(T f) const noexcept { auto t = *this; t *= f; return t; }
 		constexpr Quaternion operator/(T f) const noexcept { auto t = *this; t /= f; return t; }
 		constexpr Quaternion operator*(const Quaternion& q) const noexcept
@@ -82,30 +106,428 @@ namespace otm
 		constexpr Quaternion& operator*=(const Quaternion& q) noexcept { return *this = *this * q; }
 	};
 
+	namespace detail
+	{
+		// Axis indices of each EulerOrder, in the order rotations are applied
+		inline constexpr size_t kEulerAxes[6][3]{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+		// Shortest arc between unit vectors, or a half turn about fallback if they are opposite
+		template <class T>
+		[[nodiscard]] Quaternion<T> FromTo(const Vector<T, 3>& from, const Vector<T, 3>& to,
+			const Vector<T, 3>& fallback) noexcept
+		{
+			// Half-angle identity: (from x to, 1 + from . to) is the rotation scaled by sqrt(2 * (1 + from . to)).
+			// Normalize by its actual length, which stays accurate for inputs off unit length by rounding.
+			const auto w = 1 + (from | to);
+			if (w <= std::numeric_limits<T>::epsilon())
+				return {fallback, 0};
+			const Quaternion<T> q{from ^ to, w};
+			return q / q.Len();
+		}
+	}
+
+	template <class T>
+	Quaternion<T> Quaternion<T>::FromEuler(const EulerAngles<T>& angles, EulerOrder order) noexcept
+	{
+		const T half[3]{angles.x.Get() / 2, angles.y.Get() / 2, angles.z.Get() / 2};
+		Quaternion q;
+		for (const auto axis : detail::kEulerAxes[static_cast<size_t>(order)])
+		{
+			Quaternion r{Vector<T, 3>{}, std::cos(half[axis])};
+			r.v[axis] = std::sin(half[axis]);
+			q = r * q;
+		}
+		return q;
+	}
+
+	template <class T>
+	EulerAngles<T> Quaternion<T>::ToEuler(EulerOrder order) const noexcept
+	{
+		const auto& [i, j, k] = detail::kEulerAxes[static_cast<size_t>(order)];
+		const T e = j == (i + 1) % 3 ? 1 : -1; // Sign of the permutation
+
+		// Element r of the rotation matrix that left-multiplies column vectors, straight from the quaternion
+		const auto m = [&](size_t r, size_t c)
+		{
+			if (r == c)
+				return 1 - 2 * (v[(r + 1) % 3] * v[(r + 1) % 3] + v[(r + 2) % 3] * v[(r + 2) % 3]);
+			const auto ws = s * v[3 - r - c];
+			return 2 * (v[r] * v[c] + (c == (r + 1) % 3 ? -ws : ws));
+		};
+
+		// With M = Rk(c) * Rj(b) * Ri(a): M[k][i] = -e sin b, and row k and column i hold a and c scaled by cos b
+		T a, b, c;
+		const auto sin_b = -e * m(k, i);
+		const auto mkj = m(k, j), mkk = m(k, k);
+		const auto cos_b = std::sqrt(mkj * mkj + mkk * mkk);
+		b = std::atan2(sin_b, cos_b);
+		if (cos_b > kSmallNumV<T>)
+		{
+			a = std::atan2(e * mkj, mkk);
+			c = std::atan2(e * m(j, i), m(i, i));
+		}
+		else
+		{
+			// Only a + c or a - c is determined
+			a = std::atan2(-e * m(j, k), m(j, j));
+			c = 0;
+		}
+
+		T out[3];
+		out[i] = a;
+		out[j] = b;
+		out[k] = c;
+		return {Angle<RadR, T>{out[0]}, Angle<RadR, T>{out[1]}, Angle<RadR, T>{out[2]}};
+	}
+
+	template <class T>
+	Quaternion<T> Quaternion<T>::FromTo(const UnitVec<T, 3>& from, const UnitVec<T, 3>& to) noexcept
+	{
+		// Any perpendicular axis will do; cross with the basis axis least aligned with from, so it isn't tiny
+		const auto& f = from.Get();
+		const auto a = std::abs(f[0]), b = std::abs(f[1]), c = std::abs(f[2]);
+		Vector<T, 3> basis;
+		basis[a <= b && a <= c ? 0 : b <= c ? 1 : 2] = 1;
+		const auto perp = f ^ basis;
+		return detail::FromTo(f, to.Get(), perp / perp.Len());
+	}
+
+	template <class T>
+	Quaternion<T> Quaternion<T>::LookRotation(const UnitVec<T, 3>& forward, const UnitVec<T, 3>& up) noexcept
+	{
+		// Build the turned basis directly: Right is perpendicular to both forward and up, which keeps it level
+		const auto& f = forward.Get();
+		const auto right = up.Get() ^ f;
+		const auto len_sqr = right.LenSqr();
+		if (len_sqr <= kSmallNumV<T> * kSmallNumV<T>)
+			return FromTo(UnitVec<T, 3>::Forward(), forward);
+
+		const auto r = right / std::sqrt(len_sqr);
+		return FromAxes(f, r, f ^ r);
+	}
+
+	template <class T>
+	Quaternion<T> Quaternion<T>::FromAxes(const Vector<T, 3>& x, const Vector<T, 3>& y, const Vector<T, 3>& z) noexcept
+	{
+		Quaternion q;
+		if (const auto trace = x[0] + y[1] + z[2]; trace > 0)
+		{
+			const auto t = T(0.5) / std::sqrt(trace + 1);
+			q.v[0] = (y[2] - z[1]) * t;
+			q.v[1] = (z[0] - x[2]) * t;
+			q.v[2] = (x[1] - y[0]) * t;
+			q.s = T(0.25) / t;
+		}
+		else if (x[0] > y[1] && x[0] > z[2])
+		{
+			const auto t = 2 * std::sqrt(1 + x[0] - y[1] - z[2]);
+			q.v[0] = T(0.25) * t;
+			q.v[1] = (x[1] + y[0]) / t;
+			q.v[2] = (x[2] + z[0]) / t;
+			q.s = (y[2] - z[1]) / t;
+		}
+		else if (y[1] > z[2])
+		{
+			const auto t = 2 * std::sqrt(1 + y[1] - x[0] - z[2]);
+			q.v[0] = (x[1] + y[0]) / t;
+			q.v[1] = T(0.25) * t;
+			q.v[2] = (y[2] + z[1]) / t;
+			q.s = (z[0] - x[2]) / t;
+		}
+		else
+		{
+			const auto t = 2 * std::sqrt(1 + z[2] - x[0] - y[1]);
+			q.v[0] = (x[2] + z[0]) / t;
+			q.v[1] = (y[2] + z[1]) / t;
+			q.v[2] = T(0.25) * t;
+			q.s = (x[1] - y[0]) / t;
+		}
+		return q;
+	}
+
+	template <class T>
+	std::pair<Quaternion<T>, Quaternion<T>> Quaternion<T>::SwingTwist(const UnitVec<T, 3>& axis) const noexcept
+	{
+		// Twist keeps the part of the rotation about axis: v projected onto it
+		const auto& n = axis.Get();
+		const Quaternion<T> proj{n * (v | n), s};
+		const auto len_sqr = proj.LenSqr();
+		if (len_sqr <= kSmallNumV<T> * kSmallNumV<T>)
+			return {*this, {}};
+
+		const auto twist = proj / std::sqrt(len_sqr);
+		return {*this * *twist, twist};
+	}
+
 	template <class T, class V = T>
 	[[nodiscard]] bool IsEquivalent(const Quaternion<T>& a, const Quaternion<T>& b, V tolerance = kSmallNumV<V>) noexcept
 	{
 		return IsNearlyEqual(Vec3::one.RotatedBy(a), Vec3::one.RotatedBy(b), tolerance);
 	}
 
+	/**
+	 * \brief Normalized linear interpolation along the shorter path. Cheapest, but angular speed isn't constant:
+	 * faster in the middle. The difference from Slerp is negligible for the small angles between animation frames.
+	 * \param a, b Unit quaternions
+	 */
+	template <class T>
+	[[nodiscard]] Quaternion<T> Nlerp(const Quaternion<T>& a, const Quaternion<T>& b, T alpha) noexcept
+	{
+		const auto r = a * (1 - alpha) + b * ((a | b) < 0 ? -alpha : alpha);
+		return r / r.Len();
+	}
+
+	/**
+	 * \brief Spherical linear interpolation along the shorter path, at constant angular speed
+	 * \param a, b Unit quaternions
+	 */
+	template <class T>
+	[[nodiscard]] Quaternion<T> Slerp(const Quaternion<T>& a, const Quaternion<T>& b, T alpha) noexcept
+	{
+		const auto cos = a | b;
+		const auto abs_cos = std::abs(cos);
+
+		// sin of the angle vanishes; Nlerp is exact to rounding there
+		if (abs_cos > 1 - kSmallNumV<T>)
+			return Nlerp(a, b, alpha);
+
+		const auto angle = std::acos(abs_cos);
+		const auto inv_sin = 1 / std::sin(angle);
+		const auto wa = std::sin((1 - alpha) * angle) * inv_sin;
+		const auto wb = std::sin(alpha * angle) * inv_sin;
+		return a * wa + b * (cos < 0 ? -wb : wb);
+	}
+
+	namespace detail
+	{
+		template <class V, class T>
+		[[nodiscard]] V Splat(T x) noexcept
+		{
+			if constexpr (std::is_arithmetic_v<V>) return x;
+			else return V::Set1(x);
+		}
+
+		/**
+		 * \brief sin(alpha * angle) / sin(angle), where cos(angle) = x, without trigonometry. Eberly's polynomial
+		 * from "A Fast and Accurate Algorithm for Computing SLERP": the Taylor series in x - 1, truncated at 8 terms
+		 * with the last one scaled to compensate. Absolute error is below 2e-5 for x and alpha in [0, 1].
+		 * \tparam V T, or Pack<T> to evaluate many at once
+		 */
+		template <class T, class V>
+		[[nodiscard]] V SlerpWeight(V x, V alpha) noexcept
+		{
+			constexpr T mu = 1.85298109240830;
+			constexpr T u[8]{T(1) / (1*3), T(1) / (2*5), T(1) / (3*7), T(1) / (4*9),
+				T(1) / (5*11), T(1) / (6*13), T(1) / (7*15), mu / (8*17)};
+			constexpr T v[8]{T(1) / 3, T(2) / 5, T(3) / 7, T(4) / 9, T(5) / 11, T(6) / 13, T(7) / 15, mu * 8 / 17};
+
+			const auto one = Splat<V>(T(1));
+			const auto x_minus_1 = x - one;
+			const auto alpha_sqr = alpha * alpha;
+
+			// alpha * (1 + b0 * (1 + b1 * (... (1 + b7)))), b_i = (u_i * alpha^2 - v_i) * (x - 1)
+			auto r = one;
+			for (size_t i = 8; i-- > 0;)
+				r = (Splat<V>(u[i]) * alpha_sqr - Splat<V>(v[i])) * x_minus_1 * r + one;
+			return alpha * r;
+		}
+	}
+
+	/**
+	 * \brief Slerp approximated by a polynomial: no trigonometry, division or branch on the angle.
+	 * Component error is below 4e-5, so the result is unit to about that.
+	 * \param a, b Unit quaternions
+	 */
+	template <class T>
+	[[nodiscard]] Quaternion<T> SlerpFast(const Quaternion<T>& a, const Quaternion<T>& b, T alpha) noexcept
+	{
+		const auto cos = a | b;
+		const auto abs_cos = std::abs(cos);
+		const auto wa = detail::SlerpWeight<T>(abs_cos, 1 - alpha);
+		const auto wb = detail::SlerpWeight<T>(abs_cos, alpha);
+		return a * wa + b * (cos < 0 ? -wb : wb);
+	}
+
+	namespace detail
+	{
+		// Rotation vector (axis * half angle) of a unit quaternion
+		template <class T>
+		[[nodiscard]] Vector<T, 3> QuatLog(const Quaternion<T>& q) noexcept
+		{
+			const auto sin = q.v.Len();
+			if (sin <= kSmallNumV<T>)
+				return q.v;
+			return q.v * (std::atan2(sin, q.s) / sin);
+		}
+
+		template <class T>
+		[[nodiscard]] Quaternion<T> QuatExp(const Vector<T, 3>& w) noexcept
+		{
+			const auto angle = w.Len();
+			if (angle <= kSmallNumV<T>)
+				return {w, 1};
+			return {w * (std::sin(angle) / angle), std::cos(angle)};
+		}
+	}
+
+	/**
+	 * \brief Inner control point of q for Squad, from its neighbouring keys. The ends of a sequence can use
+	 * the key itself as its missing neighbour.
+	 * \param prev, q, next Consecutive unit quaternion keys
+	 */
+	template <class T>
+	[[nodiscard]] Quaternion<T> SquadControl(const Quaternion<T>& prev, const Quaternion<T>& q, const Quaternion<T>& next) noexcept
+	{
+		// Neighbours on the same hemisphere as q, so each log takes the shorter path
+		const auto inv = *q;
+		const auto to_prev = inv * ((q | prev) < 0 ? -prev : prev);
+		const auto to_next = inv * ((q | next) < 0 ? -next : next);
+		return q * detail::QuatExp((detail::QuatLog(to_prev) + detail::QuatLog(to_next)) * T(-0.25));
+	}
+
+	/**
+	 * \brief Spherical cubic interpolation between keys a and b, with continuous angular velocity across keys.
+	 * \param ca, cb Control points of a and b from SquadControl()
+	 */
+	template <class T>
+	[[nodiscard]] Quaternion<T> Squad(const Quaternion<T>& a, const Quaternion<T>& ca, const Quaternion<T>& cb,
+		const Quaternion<T>& b, T alpha) noexcept
+	{
+		return Slerp(Slerp(a, b, alpha), Slerp(ca, cb, alpha), 2 * alpha * (1 - alpha));
+	}
+
+	/**
+	 * \brief out[i] = Nlerp(Quaternion{a[i]}, Quaternion{b[i]}, alpha), e.g. to blend bone rotations of two poses
+	 * \param a, b Unit quaternions stored as (x, y, z, w). Must be the same size
+	 */
+	template <class T>
+	void Nlerp(const SoA<Vector<T, 4>>& a, const SoA<Vector<T, 4>>& b, T alpha, SoA<Vector<T, 4>>& out)
+	{
+		using Pack = typename SoA<Vector<T, 4>>::Pack;
+		assert(a.size() == b.size());
+
+		out.Resize(a.size());
+		const auto zero = Pack::Set1(0), one = Pack::Set1(1);
+		const auto wa = Pack::Set1(1 - alpha), wb = Pack::Set1(alpha);
+		const auto tiny = Pack::Set1(std::numeric_limits<T>::min());
+		for (size_t i = 0; i < a.PaddedSize(); i += Pack::size)
+		{
+			const auto x = a.LoadPack(i);
+			const auto y = b.LoadPack(i);
+
+			// Negate b where it is on the other hemisphere, for the shorter path
+			const auto w = SelectGreater(zero, x | y, -wb, wb);
+			Vector<Pack, 4> r;
+			for (size_t c = 0; c < 4; ++c)
+				r[c] = MulAdd(w, y[c], wa * x[c]);
+
+			// Zero padding stays zero rather than becoming NaN
+			const auto inv_len = one / Sqrt(Max(r | r, tiny));
+			for (size_t c = 0; c < 4; ++c)
+				r[c] *= inv_len;
+			out.StorePack(i, r);
+		}
+	}
+
+	/**
+	 * \brief out[i] = SlerpFast(Quaternion{a[i]}, Quaternion{b[i]}, alpha), e.g. to blend bone rotations of two poses
+	 * \param a, b Unit quaternions stored as (x, y, z, w). Must be the same size
+	 */
+	template <class T>
+	void SlerpFast(const SoA<Vector<T, 4>>& a, const SoA<Vector<T, 4>>& b, T alpha, SoA<Vector<T, 4>>& out)
+	{
+		using Pack = typename SoA<Vector<T, 4>>::Pack;
+		assert(a.size() == b.size());
+
+		out.Resize(a.size());
+		const auto zero = Pack::Set1(0);
+		const auto alpha_a = Pack::Set1(1 - alpha), alpha_b = Pack::Set1(alpha);
+		for (size_t i = 0; i < a.PaddedSize(); i += Pack::size)
+		{
+			const auto x = a.LoadPack(i);
+			const auto y = b.LoadPack(i);
+
+			const auto cos = x | y;
+			const auto abs_cos = Max(cos, -cos);
+			const auto wa = detail::SlerpWeight<T>(abs_cos, alpha_a);
+			const auto wb = detail::SlerpWeight<T>(abs_cos, alpha_b);
+			const auto w = SelectGreater(zero, cos, -wb, wb);
+
+			Vector<Pack, 4> r;
+			for (size_t c = 0; c < 4; ++c)
+				r[c] = MulAdd(w, y[c], wa * x[c]);
+			out.StorePack(i, r);
+		}
+	}
+
 	template <class T>
 	template <class F>
-	Vector<std::common_type_t<T, F>, 3> detail::VecBase<T, 3>::RotatedBy(const Quaternion<F>& q) const noexcept
+	constexpr Vector<std::common_type_t<T, F>, 3> detail::VecBase<T, 3>::RotatedBy(const Quaternion<F>& q) const noexcept
 	{
+		// Same as (q * p * ~q).v, expanded to v + 2w(q.v x v) + 2q.v x (q.v x v) and scaled by 1 / |q|^2
 		using Tf = std::common_type_t<T, F>;
-		auto& vr = static_cast<const Vector<T, 3>&>(*this);
-		const auto p = Quaternion<Tf>{Vector<Tf, 3>{vr}, 0};
-		return (q * p * ~q).v;
+		const Vector<Tf, 3> v{static_cast<const Vector<T, 3>&>(*this)};
+		const auto t = (q.v ^ v) * (2 / q.LenSqr());
+		return v + q.s * t + (q.v ^ t);
 	}
 
 	template <class T>
 	template <class F>
-	void detail::VecBase<T, 3>::RotateBy(const Quaternion<F>& q) noexcept
+	constexpr Vector<std::common_type_t<T, F>, 3> detail::VecBase<T, 3>::RotatedByUnit(const Quaternion<F>& q) const noexcept
 	{
-		static_assert(std::is_same_v<std::remove_cvref_t<decltype(this->RotatedBy())>, std::remove_cvref_t<decltype(*this)>>);
+		using Tf = std::common_type_t<T, F>;
+		const Vector<Tf, 3> v{static_cast<const Vector<T, 3>&>(*this)};
+		const auto t = (q.v ^ v) * 2;
+		return v + q.s * t + (q.v ^ t);
+	}
+
+	template <class T>
+	template <class F>
+	constexpr void detail::VecBase<T, 3>::RotateBy(const Quaternion<F>& q) noexcept
+	{
+		static_assert(std::is_same_v<std::common_type_t<T, F>, T>);
 		*this = this->RotatedBy(q);
 	}
 
+	/**
+	 * \brief Rotate array of vectors by a quaternion. Same as out[i] = in[i].RotatedBy(q)
+	 * \param in Input vectors
+	 * \param out Output vectors. May be the same as in
+	 * \param count Number of vectors
+	 */
+	template <class T>
+	void RotateVectors(const Vector<T, 3>* in, Vector<T, 3>* out, size_t count, const Quaternion<T>& q) noexcept
+	{
+		size_t i = 0;
+#if OTM_SIMD_SSE
+		if constexpr (detail::kSimdVec<T, 3>)
+		{
+			const auto f = 2 / q.LenSqr();
+			const auto qx = _mm_set1_ps(q.v[0]), qy = _mm_set1_ps(q.v[1]), qz = _mm_set1_ps(q.v[2]);
+			const auto qw = _mm_set1_ps(q.s), two = _mm_set1_ps(f);
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 x, y, z;
+				detail::SimdLoadSoA3(in[i].data, x, y, z);
+
+				// t = (q.v x v) * 2 / |q|^2
+				const auto tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qy, z), _mm_mul_ps(qz, y)));
+				const auto ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qz, x), _mm_mul_ps(qx, z)));
+				const auto tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qx, y), _mm_mul_ps(qy, x)));
+
+				// v + w * t + q.v x t
+				x = _mm_add_ps(detail::SimdMulAdd(qw, tx, x), _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(qz, ty)));
+				y = _mm_add_ps(detail::SimdMulAdd(qw, ty, y), _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz)));
+				z = _mm_add_ps(detail::SimdMulAdd(qw, tz, z), _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx)));
+
+				detail::SimdStoreSoA3(out[i].data, x, y, z);
+			}
+		}
+#endif
+		for (; i < count; ++i)
+			out[i] = in[i].RotatedBy(q);
+	}
+
 	template <class T>
 	inline const Quaternion<T> Quaternion<T>::identity = Identity();
 }
@@ -0,0 +1,195 @@
+#pragma once
+#include "GeometrySoA.hpp"
+
+/*
+ * Batched ray-triangle intersection with the same Möller–Trumbore test as Raycast(Ray, Triangle), Pack::size at a time
+ * (4 lanes with SSE, 8 with AVX, 16 with AVX-512, 1 without SIMD or with double): either one ray against that many
+ * triangles, or that many rays against one triangle. Both sides of triangles are hit.
+ */
+
+namespace otm
+{
+struct TriangleHit
+{
+    uint32_t index; // Index of the triangle
+    Float t; // Distance along the ray
+    Float u; // Weight of vertex b. The hit point is a * (1 - u - v) + b * u + c * v
+    Float v; // Weight of vertex c
+};
+
+namespace detail
+{
+/**
+ * \brief Möller–Trumbore on packs. Lanes may hold different rays, different triangles, or both.
+ * \return Bit i is set if i-th lane hits within [0, max_t]
+ */
+template <class Pack>
+[[nodiscard]] uint32_t RaycastTriangles(const Vector<Pack, 3>& origin, const Vector<Pack, 3>& dir, const Vector<Pack, 3>& a,
+                                        const Vector<Pack, 3>& e1, const Vector<Pack, 3>& e2, Pack max_t,
+                                        Pack& t, Pack& u, Pack& v) noexcept
+{
+    const auto zero = Pack::Set1(0), one = Pack::Set1(1);
+    const auto p = dir ^ e2;
+    const auto det = e1 | p;
+    const auto inv_det = one / det;
+    const auto s = origin - a;
+    const auto q = s ^ e1;
+    u = (s | p) * inv_det;
+    v = (dir | q) * inv_det;
+    t = (e2 | q) * inv_det;
+
+    // det == 0 makes the others infinite or NaN; rule it out explicitly rather than rely on how those compare
+    const auto parallel = MaskGreaterEqual(zero, det * det);
+    return ~parallel & MaskGreaterEqual(u, zero) & MaskGreaterEqual(v, zero) & MaskGreaterEqual(one, u + v)
+        & MaskGreaterEqual(t, zero) & MaskGreaterEqual(max_t, t);
+}
+}
+
+/**
+ * \brief One ray against Pack::size triangles at a time
+ * \return Nearest hit within [0, max_t], or nullopt if the ray misses every triangle
+ */
+[[nodiscard]] inline std::optional<TriangleHit> Raycast(const Ray& ray, const SoA<Triangle>& triangles,
+                                                        Float max_t = kInf) noexcept
+{
+    using Pack = SoA<Triangle>::Pack;
+
+    const auto origin = detail::Broadcast<Pack>(ray.origin);
+    const auto dir = detail::Broadcast<Pack>(ray.dir);
+
+    std::optional<TriangleHit> hit;
+    auto nearest = Pack::Set1(max_t);
+    for (size_t i = 0; i < triangles.PaddedSize(); i += Pack::size)
+    {
+        Pack t, u, v;
+        auto mask = detail::RaycastTriangles(origin, dir, triangles.A().LoadPack(i), triangles.Edge1().LoadPack(i),
+                                             triangles.Edge2().LoadPack(i), nearest, t, u, v);
+        if (i + Pack::size > triangles.size())
+            mask &= (uint32_t{1} << (triangles.size() - i)) - 1;
+        if (mask == 0)
+            continue;
+
+        Float ts[Pack::size], us[Pack::size], vs[Pack::size];
+        t.Store(ts);
+        u.Store(us);
+        v.Store(vs);
+        for (size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+            if ((mask & 1) && (!hit || ts[lane] < hit->t))
+                hit = TriangleHit{static_cast<uint32_t>(i + lane), ts[lane], us[lane], vs[lane]};
+        nearest = Pack::Set1(hit->t);
+    }
+    return hit;
+}
+
+/**
+ * \brief Up to Pack::size rays traced together. Most efficient when the rays are coherent, e.g. from nearby origins
+ * in similar directions, since they then hit and miss the same triangles.
+ */
+struct RayPacket
+{
+    using Pack = detail::Pack<Float>;
+    static constexpr size_t size = Pack::size;
+
+    Vector<Pack, 3> origin;
+    Vector<Pack, 3> dir;
+    uint32_t active = 0; // Bit i is set if i-th lane holds a ray
+
+    RayPacket() noexcept = default;
+
+    /**
+     * \param count Must be at most size
+     */
+    RayPacket(const Ray* rays, size_t count) noexcept
+    {
+        assert(count <= size);
+
+        Float lanes[6][size]{};
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                lanes[c][i] = rays[i].origin[c];
+                lanes[3 + c][i] = rays[i].dir[c];
+            }
+        }
+
+        for (size_t c = 0; c < 3; ++c)
+        {
+            origin[c] = Pack::Load(lanes[c]);
+            dir[c] = Pack::Load(lanes[3 + c]);
+        }
+        active = (uint32_t{1} << count) - 1;
+    }
+};
+
+/**
+ * \brief Nearest hit of each ray of a packet so far
+ */
+struct PacketHits
+{
+    static constexpr uint32_t kNone = ~uint32_t{0};
+
+    Float t[RayPacket::size]; // Nearest hit distance, or max_t if no hit yet
+    Float u[RayPacket::size];
+    Float v[RayPacket::size];
+    uint32_t index[RayPacket::size]; // kNone if no hit yet
+
+    /**
+     * \param max_t Hits beyond this are ignored
+     */
+    explicit PacketHits(Float max_t = kInf) noexcept
+    {
+        std::fill_n(t, RayPacket::size, max_t);
+        std::fill_n(u, RayPacket::size, Float(0));
+        std::fill_n(v, RayPacket::size, Float(0));
+        std::fill_n(index, RayPacket::size, kNone);
+    }
+
+    [[nodiscard]] std::optional<TriangleHit> operator[](size_t lane) const noexcept
+    {
+        assert(lane < RayPacket::size);
+        if (index[lane] == kNone)
+            return std::nullopt;
+        return TriangleHit{index[lane], t[lane], u[lane], v[lane]};
+    }
+};
+
+/**
+ * \brief All rays of the packet against one triangle at once. Updates the hits of rays for which it is nearer.
+ * \param index Recorded as the index of the hit triangle
+ */
+inline void Raycast(const RayPacket& rays, const Triangle& tri, uint32_t index, PacketHits& hits) noexcept
+{
+    using Pack = RayPacket::Pack;
+
+    Pack t, u, v;
+    auto mask = detail::RaycastTriangles(rays.origin, rays.dir, detail::Broadcast<Pack>(tri.a),
+                                         detail::Broadcast<Pack>(tri.b - tri.a), detail::Broadcast<Pack>(tri.c - tri.a),
+                                         Pack::Load(hits.t), t, u, v) & rays.active;
+    if (mask == 0)
+        return;
+
+    Float ts[Pack::size], us[Pack::size], vs[Pack::size];
+    t.Store(ts);
+    u.Store(us);
+    v.Store(vs);
+    for (size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+    {
+        if ((mask & 1) == 0)
+            continue;
+        hits.t[lane] = ts[lane];
+        hits.u[lane] = us[lane];
+        hits.v[lane] = vs[lane];
+        hits.index[lane] = index;
+    }
+}
+
+/**
+ * \brief All rays of the packet against each triangle in turn
+ */
+inline void Raycast(const RayPacket& rays, const Triangle* triangles, size_t count, PacketHits& hits) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        Raycast(rays, triangles[i], static_cast<uint32_t>(i), hits);
+}
+}
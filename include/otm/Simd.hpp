@@ -0,0 +1,410 @@
+#pragma once
+#include "otmfwd.hpp"
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ * Opt-in SIMD backend. Define OTM_SIMD (or turn on the OTM_SIMD CMake option) to enable it.
+ * The instruction set is selected from the compiler flags (e.g. -mavx2 -mfma, /arch:AVX2).
+ * Scalar code is always used in constant evaluation.
+ */
+#if defined(OTM_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OTM_SIMD_SSE 1
+#include <immintrin.h>
+#else
+#define OTM_SIMD_SSE 0
+#endif
+
+#if OTM_SIMD_SSE && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define OTM_SIMD_FMA 1
+#else
+#define OTM_SIMD_FMA 0
+#endif
+
+#if OTM_SIMD_SSE && defined(__AVX__)
+#define OTM_SIMD_AVX 1
+#else
+#define OTM_SIMD_AVX 0
+#endif
+
+#if OTM_SIMD_SSE && defined(__AVX2__)
+#define OTM_SIMD_AVX2 1
+#else
+#define OTM_SIMD_AVX2 0
+#endif
+
+#if OTM_SIMD_SSE && defined(__AVX512F__)
+#define OTM_SIMD_AVX512 1
+#else
+#define OTM_SIMD_AVX512 0
+#endif
+
+namespace otm
+{
+namespace detail
+{
+/**
+ * \brief Batch operations bypass the cache with non-temporal stores if their output is larger than this (in bytes)
+ */
+constexpr size_t kNonTemporalThreshold = size_t{1} << 20;
+
+/**
+ * \brief Whether Vector<T, L> has SIMD implementation of its operations
+ */
+template <class T, size_t L>
+constexpr bool kSimdVec = OTM_SIMD_SSE && std::is_same_v<T, float> && (L == 3 || L == 4);
+
+[[nodiscard]] constexpr bool IsConstantEvaluated() noexcept
+{
+#if OTM_SIMD_SSE
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+#if OTM_SIMD_SSE
+/**
+ * \brief Load 3 or 4 floats. The fourth lane is zero if L == 3.
+ */
+template <size_t L>
+[[nodiscard]] inline __m128 SimdLoad(const float* p) noexcept
+{
+    static_assert(L == 3 || L == 4);
+    if constexpr (L == 4)
+        return _mm_loadu_ps(p);
+    else
+        // __m64 may alias anything, unlike the double* of _mm_load_sd
+        return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p)), _mm_load_ss(p + 2));
+}
+
+/**
+ * \brief Store 3 or 4 floats. The fourth lane is ignored if L == 3.
+ */
+template <size_t L>
+inline void SimdStore(float* p, __m128 x) noexcept
+{
+    static_assert(L == 3 || L == 4);
+    if constexpr (L == 4)
+    {
+        _mm_storeu_ps(p, x);
+    }
+    else
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), x);
+        _mm_store_ss(p + 2, _mm_movehl_ps(x, x));
+    }
+}
+
+// a * b + c
+[[nodiscard]] inline __m128 SimdMulAdd(__m128 a, __m128 b, __m128 c) noexcept
+{
+#if OTM_SIMD_FMA
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// Horizontal sum broadcasted to all lanes
+[[nodiscard]] inline __m128 SimdHSum(__m128 x) noexcept
+{
+    x = _mm_add_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// Dot product broadcasted to all lanes
+[[nodiscard]] inline __m128 SimdDot(__m128 a, __m128 b) noexcept
+{
+    return SimdHSum(_mm_mul_ps(a, b));
+}
+
+// Cross product of xyz. The fourth lane is a.w * b.w - a.w * b.w
+[[nodiscard]] inline __m128 SimdCross(__m128 a, __m128 b) noexcept
+{
+    const auto a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const auto b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const auto c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/**
+ * \brief Load 4 packed Vector<float, 3> and transpose them to x, y, z registers
+ */
+inline void SimdLoadSoA3(const float* p, __m128& x, __m128& y, __m128& z) noexcept
+{
+    const auto a = _mm_loadu_ps(p); // x0 y0 z0 x1
+    const auto b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    const auto c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 0, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+/**
+ * \brief Transpose x, y, z registers back and store them as 4 packed Vector<float, 3>
+ * \param stream Use non-temporal stores. p must be 16-byte aligned and _mm_sfence() must follow
+ */
+inline void SimdStoreSoA3(float* p, __m128 x, __m128 y, __m128 z, bool stream = false) noexcept
+{
+    const auto a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+                                  _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    const auto b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                                  _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    const auto c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                                  _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    if (stream)
+    {
+        _mm_stream_ps(p, a);
+        _mm_stream_ps(p + 4, b);
+        _mm_stream_ps(p + 8, c);
+    }
+    else
+    {
+        _mm_storeu_ps(p, a);
+        _mm_storeu_ps(p + 4, b);
+        _mm_storeu_ps(p + 8, c);
+    }
+}
+
+/**
+ * \brief Row vector times R x C matrix by broadcasting each element of the vector to the rows of the matrix
+ * \param v Row vector of R elements
+ * \param m Row-major matrix of R x C elements
+ */
+template <size_t R, size_t C>
+[[nodiscard]] inline __m128 SimdMulRow(const float* v, const float* m) noexcept
+{
+    auto acc = _mm_mul_ps(_mm_set1_ps(v[0]), SimdLoad<C>(m));
+    for (size_t k = 1; k < R; ++k)
+        acc = SimdMulAdd(_mm_set1_ps(v[k]), SimdLoad<C>(m + k * C), acc);
+    return acc;
+}
+
+#if OTM_SIMD_AVX
+// a * b + c
+[[nodiscard]] inline __m256 SimdMulAdd(__m256 a, __m256 b, __m256 c) noexcept
+{
+#if OTM_SIMD_FMA
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+/**
+ * \brief c = a * b where a is R x C and b is C x C2. All matrices are row-major and must not overlap with c
+ */
+template <size_t R, size_t C, size_t C2>
+inline void SimdMulMat(const float* a, const float* b, float* c) noexcept
+{
+    size_t i = 0;
+#if OTM_SIMD_AVX
+    if constexpr (C == 4 && C2 == 4)
+    {
+        // Two rows at once: each 128-bit lane holds a row of a, rows of b are broadcasted to both lanes
+        const auto b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+        const auto b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+        const auto b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+        const auto b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+        for (; i + 1 < R; i += 2)
+        {
+            const auto ai = _mm256_loadu_ps(a + i * 4);
+            auto acc = _mm256_mul_ps(_mm256_permute_ps(ai, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+            acc = SimdMulAdd(_mm256_permute_ps(ai, _MM_SHUFFLE(1, 1, 1, 1)), b1, acc);
+            acc = SimdMulAdd(_mm256_permute_ps(ai, _MM_SHUFFLE(2, 2, 2, 2)), b2, acc);
+            acc = SimdMulAdd(_mm256_permute_ps(ai, _MM_SHUFFLE(3, 3, 3, 3)), b3, acc);
+            _mm256_storeu_ps(c + i * 4, acc);
+        }
+    }
+#endif
+    for (; i < R; ++i)
+        SimdStore<C2>(c + i * C2, SimdMulRow<C, C2>(a + i * C, b));
+}
+#endif
+
+/**
+ * \brief Register traits for Pack. Scalar fallback is used for types without SIMD support or when SIMD is disabled.
+ */
+template <class T>
+struct PackTraits
+{
+    using Reg = T;
+    static constexpr size_t size = 1;
+
+    static Reg Load(const T* p) noexcept { return *p; }
+    static void Store(T* p, Reg x) noexcept { *p = x; }
+    static Reg Set1(T x) noexcept { return x; }
+    static Reg Add(Reg a, Reg b) noexcept { return a + b; }
+    static Reg Sub(Reg a, Reg b) noexcept { return a - b; }
+    static Reg Mul(Reg a, Reg b) noexcept { return a * b; }
+    static Reg Div(Reg a, Reg b) noexcept { return a / b; }
+    static Reg MulAdd(Reg a, Reg b, Reg c) noexcept { return a * b + c; }
+    static Reg Min(Reg a, Reg b) noexcept { return a < b ? a : b; }
+    static Reg Max(Reg a, Reg b) noexcept { return a > b ? a : b; }
+    static Reg Sqrt(Reg a) noexcept { return std::sqrt(a); }
+    static Reg SelectGreater(Reg a, Reg b, Reg x, Reg y) noexcept { return a > b ? x : y; }
+    static uint32_t MaskGreaterEqual(Reg a, Reg b) noexcept { return a >= b; }
+};
+
+#if OTM_SIMD_AVX512
+template <>
+struct PackTraits<float>
+{
+    using Reg = __m512;
+    static constexpr size_t size = 16;
+
+    static Reg Load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+    static void Store(float* p, Reg x) noexcept { _mm512_storeu_ps(p, x); }
+    static Reg Set1(float x) noexcept { return _mm512_set1_ps(x); }
+    static Reg Add(Reg a, Reg b) noexcept { return _mm512_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) noexcept { return _mm512_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) noexcept { return _mm512_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) noexcept { return _mm512_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+    static Reg Min(Reg a, Reg b) noexcept { return _mm512_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) noexcept { return _mm512_max_ps(a, b); }
+    static Reg Sqrt(Reg a) noexcept { return _mm512_sqrt_ps(a); }
+
+    static Reg SelectGreater(Reg a, Reg b, Reg x, Reg y) noexcept
+    {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), y, x);
+    }
+
+    static uint32_t MaskGreaterEqual(Reg a, Reg b) noexcept
+    {
+        return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ);
+    }
+};
+#elif OTM_SIMD_AVX
+template <>
+struct PackTraits<float>
+{
+    using Reg = __m256;
+    static constexpr size_t size = 8;
+
+    static Reg Load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void Store(float* p, Reg x) noexcept { _mm256_storeu_ps(p, x); }
+    static Reg Set1(float x) noexcept { return _mm256_set1_ps(x); }
+    static Reg Add(Reg a, Reg b) noexcept { return _mm256_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) noexcept { return _mm256_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) noexcept { return _mm256_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) noexcept { return _mm256_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) noexcept { return SimdMulAdd(a, b, c); }
+    static Reg Min(Reg a, Reg b) noexcept { return _mm256_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) noexcept { return _mm256_max_ps(a, b); }
+    static Reg Sqrt(Reg a) noexcept { return _mm256_sqrt_ps(a); }
+
+    static Reg SelectGreater(Reg a, Reg b, Reg x, Reg y) noexcept
+    {
+        return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_GT_OQ));
+    }
+
+    static uint32_t MaskGreaterEqual(Reg a, Reg b) noexcept
+    {
+        return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+    }
+};
+#elif OTM_SIMD_SSE
+template <>
+struct PackTraits<float>
+{
+    using Reg = __m128;
+    static constexpr size_t size = 4;
+
+    static Reg Load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void Store(float* p, Reg x) noexcept { _mm_storeu_ps(p, x); }
+    static Reg Set1(float x) noexcept { return _mm_set1_ps(x); }
+    static Reg Add(Reg a, Reg b) noexcept { return _mm_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) noexcept { return _mm_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) noexcept { return _mm_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) noexcept { return _mm_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) noexcept { return SimdMulAdd(a, b, c); }
+    static Reg Min(Reg a, Reg b) noexcept { return _mm_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) noexcept { return _mm_max_ps(a, b); }
+    static Reg Sqrt(Reg a) noexcept { return _mm_sqrt_ps(a); }
+
+    static Reg SelectGreater(Reg a, Reg b, Reg x, Reg y) noexcept
+    {
+        const auto mask = _mm_cmpgt_ps(a, b);
+        return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+    }
+
+    static uint32_t MaskGreaterEqual(Reg a, Reg b) noexcept
+    {
+        return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+    }
+};
+#endif
+
+/**
+ * \brief As many values of T as the widest available SIMD register holds.
+ * Behaves like an arithmetic type so it can be used as a component type of Vector (e.g. Vector<Pack<float>, 3>).
+ */
+template <class T>
+struct Pack
+{
+    using Traits = PackTraits<T>;
+    static constexpr size_t size = Traits::size;
+
+    typename Traits::Reg v{};
+
+    [[nodiscard]] static Pack Load(const T* p) noexcept { return {Traits::Load(p)}; }
+    [[nodiscard]] static Pack Set1(T x) noexcept { return {Traits::Set1(x)}; }
+    void Store(T* p) const noexcept { Traits::Store(p, v); }
+
+    Pack operator-() const noexcept { return {Traits::Sub(Traits::Set1(0), v)}; }
+    Pack operator+(Pack b) const noexcept { return {Traits::Add(v, b.v)}; }
+    Pack operator-(Pack b) const noexcept { return {Traits::Sub(v, b.v)}; }
+    Pack operator*(Pack b) const noexcept { return {Traits::Mul(v, b.v)}; }
+    Pack operator/(Pack b) const noexcept { return {Traits::Div(v, b.v)}; }
+    Pack& operator+=(Pack b) noexcept { return *this = *this + b; }
+    Pack& operator-=(Pack b) noexcept { return *this = *this - b; }
+    Pack& operator*=(Pack b) noexcept { return *this = *this * b; }
+    Pack& operator/=(Pack b) noexcept { return *this = *this / b; }
+
+    // a * b + c
+    friend Pack MulAdd(Pack a, Pack b, Pack c) noexcept { return {Traits::MulAdd(a.v, b.v, c.v)}; }
+    friend Pack Min(Pack a, Pack b) noexcept { return {Traits::Min(a.v, b.v)}; }
+    friend Pack Max(Pack a, Pack b) noexcept { return {Traits::Max(a.v, b.v)}; }
+    friend Pack Sqrt(Pack a) noexcept { return {Traits::Sqrt(a.v)}; }
+
+    // a > b ? x : y for each lane
+    friend Pack SelectGreater(Pack a, Pack b, Pack x, Pack y) noexcept
+    {
+        return {Traits::SelectGreater(a.v, b.v, x.v, y.v)};
+    }
+
+    // Bit i is set if a >= b for i-th lane
+    friend uint32_t MaskGreaterEqual(Pack a, Pack b) noexcept
+    {
+        return Traits::MaskGreaterEqual(a.v, b.v);
+    }
+};
+}
+}
+
+namespace std
+{
+// Arithmetic with Pack<T> results in Pack<T> (e.g. CommonFloat<Pack<float>>)
+template <class T, class U>
+struct common_type<otm::detail::Pack<T>, U>
+{
+    using type = otm::detail::Pack<T>;
+};
+
+template <class T, class U>
+struct common_type<U, otm::detail::Pack<T>>
+{
+    using type = otm::detail::Pack<T>;
+};
+
+template <class T>
+struct common_type<otm::detail::Pack<T>, otm::detail::Pack<T>>
+{
+    using type = otm::detail::Pack<T>;
+};
+}
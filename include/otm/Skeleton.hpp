@@ -0,0 +1,88 @@
+#pragma once
+#include "Transform.hpp"
+
+/*
+ * Pose evaluation for skeletons stored as flat arrays indexed by bone. parents[i] is the index of the parent of bone i,
+ * or kNoParent for a root, and every parent must come before its children, so one pass in index order sees each
+ * parent's model transform before its children need it.
+ * Model transforms and skinning matrices are 4x3 affine matrices: exact under non-uniform scale, which composing
+ * Transforms isn't, and 48 bytes per bone instead of 64. Use Mat4::Identity(m) where a full matrix is needed.
+ */
+
+namespace otm
+{
+constexpr int32_t kNoParent = -1;
+
+/**
+ * \return True if every parent index is kNoParent or less than the index of its child
+ */
+[[nodiscard]] inline bool IsParentsFirst(const int32_t* parents, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        if (parents[i] != kNoParent && (parents[i] < 0 || static_cast<size_t>(parents[i]) >= i))
+            return false;
+    return true;
+}
+
+/**
+ * \brief Model transform of each bone from its transform relative to its parent:
+ * model[i] = local[i] * model[parents[i]], or local[i] for roots
+ * \param parents Parent of each bone. Parents must come first; see IsParentsFirst()
+ * \param local Transform of each bone relative to its parent
+ * \param model Output model transforms
+ * \param count Number of bones
+ */
+inline void LocalToModel(const int32_t* parents, const Transform* local, Mat4x3* model, size_t count) noexcept
+{
+    assert(IsParentsFirst(parents, count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto m = local[i].ToAffine();
+        model[i] = parents[i] == kNoParent ? m : MulAffine(m, model[parents[i]]);
+    }
+}
+
+/**
+ * \brief Skinning matrices: palette[i] = inverse_bind[i] * model[i], which takes a vertex from model space in the
+ * bind pose to model space in the current pose
+ * \param model Model transform of each bone in the current pose
+ * \param inverse_bind Inverse of the model transform of each bone in the bind pose
+ * \param palette Output skinning matrices. May be the same as model
+ * \param count Number of bones
+ */
+inline void SkinningPalette(const Mat4x3* model, const Mat4x3* inverse_bind, Mat4x3* palette, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        palette[i] = MulAffine(inverse_bind[i], model[i]);
+}
+
+/**
+ * \brief LocalToModel() and SkinningPalette() fused into one pass, so each model transform is used while still in cache
+ * \param model Output model transforms. Parents are read back from here, so it can't be the same as palette
+ */
+inline void EvaluatePose(const int32_t* parents, const Transform* local, const Mat4x3* inverse_bind, Mat4x3* model,
+                         Mat4x3* palette, size_t count) noexcept
+{
+    assert(IsParentsFirst(parents, count));
+    assert(model != palette);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto m = local[i].ToAffine();
+        model[i] = parents[i] == kNoParent ? m : MulAffine(m, model[parents[i]]);
+        palette[i] = MulAffine(inverse_bind[i], model[i]);
+    }
+}
+
+/**
+ * \brief Inverse bind matrices from the bind pose, for SkinningPalette()
+ * \param bind_local Transform of each bone relative to its parent in the bind pose
+ * \param inverse_bind Output inverse model transforms. A bone with a nearly zero scale gets the identity.
+ */
+inline void InverseBindPoses(const int32_t* parents, const Transform* bind_local, Mat4x3* inverse_bind,
+                             size_t count) noexcept
+{
+    LocalToModel(parents, bind_local, inverse_bind, count);
+    for (size_t i = 0; i < count; ++i)
+        inverse_bind[i] = InvAffine(inverse_bind[i]).value_or(Mat4x3{Mat3::identity});
+}
+}
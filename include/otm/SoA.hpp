@@ -0,0 +1,420 @@
+#pragma once
+#include "Matrix.hpp"
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace otm
+{
+template <class V>
+class SoA;
+
+/**
+ * \brief Structure-of-arrays container of vectors. Each component is stored in its own aligned stream,
+ * so operations process as many vectors at once as the widest SIMD register holds.
+ * \note Streams are padded to a multiple of the SIMD width. Operations also run on the padding, which is never exposed.
+ */
+template <class T, size_t L>
+class SoA<Vector<T, L>>
+{
+public:
+    using value_type = Vector<T, L>;
+    using size_type = size_t;
+    using Pack = detail::Pack<T>;
+
+    static constexpr size_t kAlign = 64;
+
+    SoA() noexcept = default;
+
+    explicit SoA(size_t size)
+    {
+        Resize(size);
+    }
+
+    SoA(const Vector<T, L>* vectors, size_t count)
+        : SoA{count}
+    {
+        for (size_t i = 0; i < count; ++i)
+            Set(i, vectors[i]);
+    }
+
+    SoA(const SoA& other)
+        : SoA{}
+    {
+        *this = other;
+    }
+
+    SoA(SoA&& other) noexcept
+        : data_{std::move(other.data_)}, size_{other.size_}, capacity_{other.capacity_}
+    {
+        other.size_ = other.capacity_ = 0;
+    }
+
+    SoA& operator=(const SoA& other)
+    {
+        if (this != &other)
+        {
+            Resize(other.size_);
+            for (size_t c = 0; c < L; ++c)
+                std::copy_n(other.Data(c), other.PaddedSize(), Data(c));
+        }
+        return *this;
+    }
+
+    SoA& operator=(SoA&& other) noexcept
+    {
+        data_ = std::move(other.data_);
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.size_ = other.capacity_ = 0;
+        return *this;
+    }
+
+    ~SoA() = default;
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    void Reserve(size_t capacity)
+    {
+        // Round up to multiple of both the SIMD width and the alignment
+        constexpr auto kStep = Max(kAlign / sizeof(T), Pack::size);
+        capacity = (capacity + kStep - 1) / kStep * kStep;
+        if (capacity <= capacity_)
+            return;
+
+        Buffer data{static_cast<T*>(::operator new[](capacity * L * sizeof(T), std::align_val_t{kAlign}))};
+        std::fill_n(data.get(), capacity * L, T{});
+        for (size_t c = 0; c < L && data_; ++c)
+            std::copy_n(Data(c), size_, data.get() + c * capacity);
+
+        data_ = std::move(data);
+        capacity_ = capacity;
+    }
+
+    /**
+     * \brief Resize the container. New elements are zero.
+     */
+    void Resize(size_t size)
+    {
+        Reserve(size);
+        for (size_t c = 0; c < L && size > size_; ++c)
+            std::fill(Data(c) + size_, Data(c) + size, T{});
+        size_ = size;
+    }
+
+    void PushBack(const Vector<T, L>& v)
+    {
+        if (size_ == capacity_)
+            Reserve(Max(capacity_ * 2, size_t{1}));
+        Set(size_++, v);
+    }
+
+    void Clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    [[nodiscard]] Vector<T, L> operator[](size_t i) const noexcept
+    {
+        assert(i < size_);
+        Vector<T, L> v;
+        for (size_t c = 0; c < L; ++c)
+            v[c] = Data(c)[i];
+        return v;
+    }
+
+    void Set(size_t i, const Vector<T, L>& v) noexcept
+    {
+        assert(i < size_);
+        for (size_t c = 0; c < L; ++c)
+            Data(c)[i] = v[c];
+    }
+
+    /**
+     * \brief Stream of c-th component. Aligned to kAlign.
+     */
+    [[nodiscard]] T* Data(size_t c) noexcept
+    {
+        assert(c < L);
+        return data_.get() + c * capacity_;
+    }
+
+    [[nodiscard]] const T* Data(size_t c) const noexcept
+    {
+        assert(c < L);
+        return data_.get() + c * capacity_;
+    }
+
+    /**
+     * \brief Load Pack::size vectors starting from i-th
+     */
+    [[nodiscard]] Vector<Pack, L> LoadPack(size_t i) const noexcept
+    {
+        Vector<Pack, L> v;
+        for (size_t c = 0; c < L; ++c)
+            v[c] = Pack::Load(Data(c) + i);
+        return v;
+    }
+
+    void StorePack(size_t i, const Vector<Pack, L>& v) noexcept
+    {
+        for (size_t c = 0; c < L; ++c)
+            v[c].Store(Data(c) + i);
+    }
+
+    /**
+     * \brief Size rounded up to multiple of Pack::size. Loop up to this with LoadPack/StorePack.
+     */
+    [[nodiscard]] size_t PaddedSize() const noexcept
+    {
+        return (size_ + Pack::size - 1) / Pack::size * Pack::size;
+    }
+
+    SoA& operator+=(const SoA& b) noexcept
+    {
+        return Apply(b, [](auto& x, auto& y) { x += y; });
+    }
+
+    SoA& operator-=(const SoA& b) noexcept
+    {
+        return Apply(b, [](auto& x, auto& y) { x -= y; });
+    }
+
+    // Component-wise multiplication
+    SoA& operator*=(const SoA& b) noexcept
+    {
+        return Apply(b, [](auto& x, auto& y) { x *= y; });
+    }
+
+    SoA& operator+=(const Vector<T, L>& v) noexcept
+    {
+        const auto p = Broadcast(v);
+        return Apply([&](auto& x) { x += p; });
+    }
+
+    SoA& operator-=(const Vector<T, L>& v) noexcept
+    {
+        const auto p = Broadcast(v);
+        return Apply([&](auto& x) { x -= p; });
+    }
+
+    SoA& operator*=(T f) noexcept
+    {
+        const auto p = Pack::Set1(f);
+        return Apply([&](auto& x) { x *= p; });
+    }
+
+    SoA& operator/=(T f) noexcept
+    {
+        const auto p = Pack::Set1(1 / f);
+        return Apply([&](auto& x) { x *= p; });
+    }
+
+    /**
+     * \brief Multiply each vector (as row vector) by the matrix
+     */
+    SoA& operator*=(const Matrix<T, L, L>& m) noexcept
+    {
+        Vector<Pack, L> rows[L];
+        for (size_t k = 0; k < L; ++k)
+            rows[k] = Broadcast(m[k]);
+
+        return Apply([&](auto& x)
+        {
+            auto r = rows[0] * x[0];
+            for (size_t k = 1; k < L; ++k)
+                for (size_t j = 0; j < L; ++j)
+                    r[j] = MulAdd(rows[k][j], x[k], r[j]);
+            x = r;
+        });
+    }
+
+    /**
+     * \brief Normalize each vector. Vectors of nearly zero length are left unchanged.
+     */
+    void Normalize() noexcept
+    {
+        static_assert(std::is_floating_point_v<T>);
+        const auto small = Pack::Set1(kSmallNumV<T>), one = Pack::Set1(1);
+        Apply([&](auto& x)
+        {
+            const auto len_sqr = x | x;
+            x *= SelectGreater(len_sqr, small, one / Sqrt(len_sqr), one);
+        });
+    }
+
+    /**
+     * \brief Rotate each vector by the quaternion. Same as RotatedBy() for each vector.
+     */
+    void RotateBy(const Quaternion<T>& q) noexcept
+    {
+        static_assert(L == 3);
+        const auto qv = Broadcast(q.v);
+        const auto qs = Pack::Set1(q.s);
+        const auto f = Pack::Set1(2 / q.LenSqr());
+        Apply([&](auto& x)
+        {
+            const auto t = (qv ^ x) * f;
+            x += qs * t + (qv ^ t);
+        });
+    }
+
+    /**
+     * \brief Transform each vector as a point. Same as TransformPoint() for each vector.
+     * \param m 4x4 matrix or 4x3 affine matrix
+     */
+    template <size_t C>
+    void TransformPoints(const Matrix<T, 4, C>& m) noexcept
+    {
+        static_assert(L == 3);
+        TransformAffine(m, true);
+    }
+
+    /**
+     * \brief Transform each vector as a direction. Same as TransformDirection() for each vector.
+     * \param m 4x4 matrix or 4x3 affine matrix
+     */
+    template <size_t C>
+    void TransformDirections(const Matrix<T, 4, C>& m) noexcept
+    {
+        static_assert(L == 3);
+        TransformAffine(m, false);
+    }
+
+private:
+    struct Deleter
+    {
+        void operator()(T* p) const noexcept
+        {
+            ::operator delete[](p, std::align_val_t{kAlign});
+        }
+    };
+
+    using Buffer = std::unique_ptr<T[], Deleter>;
+
+    template <size_t L2>
+    [[nodiscard]] static Vector<Pack, L2> Broadcast(const Vector<T, L2>& v) noexcept
+    {
+        Vector<Pack, L2> p;
+        for (size_t c = 0; c < L2; ++c)
+            p[c] = Pack::Set1(v[c]);
+        return p;
+    }
+
+    template <class Fn>
+    SoA& Apply(Fn&& fn) noexcept
+    {
+        for (size_t i = 0; i < PaddedSize(); i += Pack::size)
+        {
+            auto x = LoadPack(i);
+            fn(x);
+            StorePack(i, x);
+        }
+        return *this;
+    }
+
+    template <class Fn>
+    SoA& Apply(const SoA& b, Fn&& fn) noexcept
+    {
+        assert(size_ == b.size_);
+        for (size_t i = 0; i < PaddedSize(); i += Pack::size)
+        {
+            auto x = LoadPack(i);
+            auto y = b.LoadPack(i);
+            fn(x, y);
+            StorePack(i, x);
+        }
+        return *this;
+    }
+
+    template <size_t C>
+    void TransformAffine(const Matrix<T, 4, C>& m, bool translate) noexcept
+    {
+        static_assert(C == 3 || C == 4);
+        const auto r0 = Broadcast(Vector<T, 3>{m[0]});
+        const auto r1 = Broadcast(Vector<T, 3>{m[1]});
+        const auto r2 = Broadcast(Vector<T, 3>{m[2]});
+        const auto t = Broadcast(translate ? Vector<T, 3>{m[3]} : Vector<T, 3>{});
+        Apply([&](auto& x)
+        {
+            Vector<Pack, 3> r;
+            for (size_t j = 0; j < 3; ++j)
+                r[j] = MulAdd(x[0], r0[j], MulAdd(x[1], r1[j], MulAdd(x[2], r2[j], t[j])));
+            x = r;
+        });
+    }
+
+    Buffer data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+/**
+ * \brief out[i] = a[i] | b[i]
+ * \param out Array of at least a.size() elements
+ */
+template <class T, size_t L>
+void Dot(const SoA<Vector<T, L>>& a, const SoA<Vector<T, L>>& b, T* out) noexcept
+{
+    using Pack = typename SoA<Vector<T, L>>::Pack;
+    assert(a.size() == b.size());
+
+    size_t i = 0;
+    for (; i + Pack::size <= a.size(); i += Pack::size)
+        (a.LoadPack(i) | b.LoadPack(i)).Store(out + i);
+
+    if (i < a.size())
+    {
+        T tail[Pack::size];
+        (a.LoadPack(i) | b.LoadPack(i)).Store(tail);
+        std::copy(tail, tail + (a.size() - i), out + i);
+    }
+}
+
+/**
+ * \brief out[i] = a[i] ^ b[i]
+ */
+template <class T>
+void Cross(const SoA<Vector<T, 3>>& a, const SoA<Vector<T, 3>>& b, SoA<Vector<T, 3>>& out)
+{
+    assert(a.size() == b.size());
+    out.Resize(a.size());
+    for (size_t i = 0; i < a.PaddedSize(); i += SoA<Vector<T, 3>>::Pack::size)
+        out.StorePack(i, a.LoadPack(i) ^ b.LoadPack(i));
+}
+
+/**
+ * \brief out[i] = Lerp(a[i], b[i], alpha)
+ */
+template <class T, size_t L>
+void Lerp(const SoA<Vector<T, L>>& a, const SoA<Vector<T, L>>& b, T alpha, SoA<Vector<T, L>>& out)
+{
+    using Pack = typename SoA<Vector<T, L>>::Pack;
+    assert(a.size() == b.size());
+
+    out.Resize(a.size());
+    const auto p = Pack::Set1(alpha);
+    for (size_t i = 0; i < a.PaddedSize(); i += Pack::size)
+    {
+        const auto x = a.LoadPack(i);
+        const auto y = b.LoadPack(i);
+        Vector<Pack, L> r;
+        for (size_t c = 0; c < L; ++c)
+            r[c] = MulAdd(p, y[c] - x[c], x[c]);
+        out.StorePack(i, r);
+    }
+}
+}
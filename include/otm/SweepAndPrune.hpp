@@ -0,0 +1,236 @@
+#pragma once
+#include "Geometry.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace otm
+{
+/**
+ * \brief Sweep and prune broadphase. Finds all pairs of overlapping AABBs.
+ * Endpoints of every axis stay sorted across updates, so when items move little between frames the insertion sort is
+ * close to linear, and the sweep can switch to whichever axis currently separates items best without resorting.
+ * Nothing is allocated once the item count and the number of pairs stop growing.
+ * Items are referred to by their index in the array passed to Update().
+ */
+class SweepAndPrune
+{
+public:
+    struct Pair
+    {
+        uint32_t a; // Always less than b
+        uint32_t b;
+    };
+
+    /**
+     * \brief Re-sort endpoints and find overlapping pairs. Results are available from Pairs() until the next update.
+     * Items should be passed in the same order every time; if count changes, everything is sorted from scratch.
+     */
+    void Update(const AABB* boxes, size_t count)
+    {
+        if (count != size())
+            Reset(count);
+
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            auto& endpoints = endpoints_[axis];
+            for (auto& e : endpoints)
+                e.value = e.IsMax() ? boxes[e.Item()].max[axis] : boxes[e.Item()].min[axis];
+
+            if (count != sorted_count_)
+                std::sort(endpoints.begin(), endpoints.end());
+            else
+                InsertionSort(endpoints);
+        }
+        sorted_count_ = count;
+
+        const auto axis = SweepAxis(boxes, count);
+        Sweep(boxes, endpoints_[axis], axis);
+    }
+
+    void Update(const Sphere* spheres, size_t count)
+    {
+        bounds_.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            bounds_[i] = Bounds(spheres[i]);
+        Update(bounds_.data(), count);
+    }
+
+    /**
+     * \brief Overlapping pairs found by the last update, in no particular order
+     */
+    [[nodiscard]] const std::vector<Pair>& Pairs() const noexcept
+    {
+        return pairs_;
+    }
+
+    /**
+     * \brief Number of items
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return active_pos_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return active_pos_.empty();
+    }
+
+private:
+    struct Endpoint
+    {
+        Float value;
+        uint32_t key; // Item index << 1 | is max
+
+        [[nodiscard]] uint32_t Item() const noexcept
+        {
+            return key >> 1;
+        }
+
+        [[nodiscard]] bool IsMax() const noexcept
+        {
+            return key & 1;
+        }
+
+        // Min before max on ties, so that touching boxes overlap as in IsOverlapped()
+        [[nodiscard]] bool operator<(const Endpoint& e) const noexcept
+        {
+            return value < e.value || (value == e.value && (key & 1) < (e.key & 1));
+        }
+    };
+
+    void Reset(size_t count)
+    {
+        for (auto& endpoints : endpoints_)
+        {
+            endpoints.resize(count * 2);
+            for (uint32_t i = 0; i < count * 2; ++i)
+                endpoints[i].key = i;
+        }
+        active_pos_.resize(count);
+        sorted_count_ = ~size_t{0};
+    }
+
+    static void InsertionSort(std::vector<Endpoint>& endpoints) noexcept
+    {
+        for (size_t i = 1; i < endpoints.size(); ++i)
+        {
+            const auto e = endpoints[i];
+            auto j = i;
+            for (; j > 0 && e < endpoints[j - 1]; --j)
+                endpoints[j] = endpoints[j - 1];
+            endpoints[j] = e;
+        }
+    }
+
+    // Axis along which centers spread the most, so the fewest intervals overlap
+    [[nodiscard]] static size_t SweepAxis(const AABB* boxes, size_t count) noexcept
+    {
+        Vec3 sum, sum_sqr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto c = boxes[i].Center();
+            sum += c;
+            sum_sqr += c * c;
+        }
+
+        const auto variance = sum_sqr * static_cast<Float>(count) - sum * sum;
+        return variance[0] > variance[1] ? (variance[0] > variance[2] ? 0 : 2) : (variance[1] > variance[2] ? 1 : 2);
+    }
+
+    void Sweep(const AABB* boxes, const std::vector<Endpoint>& endpoints, size_t axis)
+    {
+        using Pack = detail::Pack<Float>;
+        pairs_.clear();
+
+        // Only the other two axes need testing
+        const auto u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+        for (const auto& e : endpoints)
+        {
+            const auto i = e.Item();
+            if (e.IsMax())
+            {
+                active_.Remove(active_pos_[i], active_pos_);
+                continue;
+            }
+
+            const auto& box = boxes[i];
+            const auto min_u = Pack::Set1(box.min[u]), min_v = Pack::Set1(box.min[v]);
+            const auto max_u = Pack::Set1(box.max[u]), max_v = Pack::Set1(box.max[v]);
+            for (size_t k = 0; k < active_.size; k += Pack::size)
+            {
+                const auto mask = MaskGreaterEqual(Pack::Load(&active_.max_u[k]), min_u)
+                    & MaskGreaterEqual(max_u, Pack::Load(&active_.min_u[k]))
+                    & MaskGreaterEqual(Pack::Load(&active_.max_v[k]), min_v)
+                    & MaskGreaterEqual(max_v, Pack::Load(&active_.min_v[k]));
+                if (mask == 0)
+                    continue;
+
+                for (size_t lane = 0; lane < Pack::size; ++lane)
+                {
+                    if ((mask >> lane & 1) == 0)
+                        continue;
+                    const auto j = active_.index[k + lane];
+                    pairs_.push_back(i < j ? Pair{i, j} : Pair{j, i});
+                }
+            }
+
+            active_pos_[i] = static_cast<uint32_t>(active_.size);
+            active_.Add(box.min[u], box.min[v], box.max[u], box.max[v], i, Pack::size);
+        }
+    }
+
+    /**
+     * \brief Items whose interval on the sweep axis contains the sweep position, with bounds on the other two axes.
+     * Bounds are kept padded to a whole number of packs with empty intervals that never overlap.
+     */
+    struct Active
+    {
+        std::vector<Float> min_u, min_v, max_u, max_v;
+        std::vector<uint32_t> index;
+        size_t size = 0;
+
+        void Add(Float lu, Float lv, Float hu, Float hv, uint32_t item, size_t pack_size)
+        {
+            if (size == index.size())
+            {
+                const auto padded = size + pack_size;
+                min_u.resize(padded, kInf);
+                min_v.resize(padded, kInf);
+                max_u.resize(padded, -kInf);
+                max_v.resize(padded, -kInf);
+                index.resize(padded);
+            }
+
+            Set(size++, lu, lv, hu, hv, item);
+        }
+
+        // Swap-remove, keeping pos up to date
+        void Remove(size_t at, std::vector<uint32_t>& pos) noexcept
+        {
+            const auto last = --size;
+            Set(at, min_u[last], min_v[last], max_u[last], max_v[last], index[last]);
+            pos[index[at]] = static_cast<uint32_t>(at);
+            Set(last, kInf, kInf, -kInf, -kInf, 0);
+        }
+
+        void Set(size_t at, Float lu, Float lv, Float hu, Float hv, uint32_t item) noexcept
+        {
+            min_u[at] = lu;
+            min_v[at] = lv;
+            max_u[at] = hu;
+            max_v[at] = hv;
+            index[at] = item;
+        }
+    };
+
+    std::vector<Endpoint> endpoints_[3];
+    Active active_;
+    std::vector<uint32_t> active_pos_; // Index of each item in active_
+    std::vector<Pair> pairs_;
+    std::vector<AABB> bounds_; // Scratch for spheres
+    size_t sorted_count_ = 0;
+};
+}
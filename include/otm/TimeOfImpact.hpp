@@ -0,0 +1,204 @@
+#pragma once
+#include "Transform.hpp"
+
+/*
+ * Continuous collision. A sphere moving by `motion` is tested against the whole swept volume at once, so fast
+ * objects can't tunnel through thin geometry between steps. Times are fractions of the motion in [0, 1]:
+ * the sphere touches the target when its center is at s.pos + motion * t. Touching at the start gives 0.
+ */
+
+namespace otm
+{
+[[nodiscard]] inline std::optional<Float> TimeOfImpact(const Sphere& s, const Vec3& motion, const Sphere& target) noexcept
+{
+    return Raycast(Ray{s.pos, motion}, Sphere{target.pos, s.radius + target.radius}, 1);
+}
+
+/**
+ * \brief Either side of the plane counts as impact
+ */
+[[nodiscard]] constexpr std::optional<Float> TimeOfImpact(const Sphere& s, const Vec3& motion, const Plane& target) noexcept
+{
+    const auto dist = target.Dist(s.pos);
+    if (Abs(dist) <= s.radius)
+        return Float(0);
+
+    // Moving toward the plane from whichever side the sphere is on
+    const auto speed = target.normal | motion;
+    const auto side = dist > 0 ? Float(1) : Float(-1);
+    if (speed * side >= 0)
+        return std::nullopt;
+
+    const auto t = (side * s.radius - dist) / speed;
+    return t <= 1 ? std::optional{t} : std::nullopt;
+}
+
+/**
+ * \brief Center ray against the box rounded by the radius: box grown by the radius, then the edge capsules if the
+ * hit lands in an edge or corner region
+ */
+[[nodiscard]] inline std::optional<Float> TimeOfImpact(const Sphere& s, const Vec3& motion, const AABB& target) noexcept
+{
+    const Ray ray{s.pos, motion};
+    const Vec3 r{All{}, s.radius};
+    const auto t = Raycast(ray, AABB{target.min - r, target.max + r}, 1);
+    if (!t)
+        return std::nullopt;
+
+    // Exact if the center is outside the box along at most one axis
+    const auto p = ray.At(*t);
+    size_t outside = 0;
+    for (size_t i = 0; i < 3; ++i)
+        outside += (p[i] < target.min[i]) | (p[i] > target.max[i]);
+    if (outside <= 1)
+        return t;
+
+    // Rounded box is the union of the box grown along each axis alone and the capsules around the 12 edges
+    std::optional<Float> first;
+    const auto Keep = [&](std::optional<Float> hit)
+    {
+        if (hit && (!first || *hit < *first))
+            first = hit;
+    };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        auto grown = target;
+        grown.min[i] -= s.radius;
+        grown.max[i] += s.radius;
+        Keep(Raycast(ray, grown, 1));
+    }
+
+    const auto Corner = [&](size_t bits)
+    {
+        return Vec3{bits & 1 ? target.max[0] : target.min[0], bits & 2 ? target.max[1] : target.min[1],
+                    bits & 4 ? target.max[2] : target.min[2]};
+    };
+
+    for (size_t bits = 0; bits < 8; ++bits)
+        for (size_t axis = 0; axis < 3; ++axis)
+            if ((bits >> axis & 1) == 0)
+                Keep(Raycast(ray, Capsule{Corner(bits), Corner(bits | size_t{1} << axis), s.radius}, 1));
+
+    return first;
+}
+
+/**
+ * \brief Both sides of the triangle count as impact. Face first, then the edge capsules.
+ */
+[[nodiscard]] inline std::optional<Float> TimeOfImpact(const Sphere& s, const Vec3& motion, const Triangle& target) noexcept
+{
+    const Ray ray{s.pos, motion};
+
+    // Degenerate triangles have no face; their edges still collide
+    if (const auto n = target.Normal().Unit())
+    {
+        const auto& normal = n->Get();
+        const auto dist = normal | (s.pos - target.a);
+        const auto side = dist >= 0 ? Float(1) : Float(-1);
+        const auto speed = normal | motion;
+
+        // When the center first comes within radius of the plane
+        std::optional<Float> t;
+        if (Abs(dist) <= s.radius)
+            t = Float(0);
+        else if (speed * side < 0)
+            t = (side * s.radius - dist) / speed;
+
+        if (t && *t <= 1)
+        {
+            // If the contact point is inside the triangle nothing could have been hit earlier
+            const auto plane_dist = Abs(dist) <= s.radius ? dist : side * s.radius;
+            const auto q = ray.At(*t) - normal * plane_dist;
+            const auto Inside = [&](const Vec3& a, const Vec3& b) { return (((b - a) ^ (q - a)) | normal) >= 0; };
+            if (Inside(target.a, target.b) && Inside(target.b, target.c) && Inside(target.c, target.a))
+                return t;
+        }
+    }
+
+    std::optional<Float> first;
+    for (const auto& [a, b] : {std::pair{target.a, target.b}, std::pair{target.b, target.c}, std::pair{target.c, target.a}})
+    {
+        const auto hit = Raycast(ray, Capsule{a, b, s.radius}, 1);
+        if (hit && (!first || *hit < *first))
+            first = hit;
+    }
+    return first;
+}
+
+struct ToiResult
+{
+    Float time; // Time of impact if converged. Otherwise the time reached, before which there is certainly no impact
+    bool converged; // False if max_iterations ran out before the separation dropped to tolerance
+};
+
+/**
+ * \brief Time of impact of two shapes moving from pose 0 to pose 1, by conservative advancement.
+ * Position is interpolated linearly and rotation at constant angular velocity; scale stays at pose 0.
+ * Each step advances by the distance between the shapes divided by an upper bound of how fast they can approach,
+ * so shapes never pass through each other, whatever their shape.
+ * \param distance Called as distance(pose_a, pose_b). Returns the separation between the shapes, <= 0 if touching
+ * \param radius_a, radius_b Maximum distance from the transform origin to any point of the shape in world units,
+ * bounding motion due to rotation
+ * \param tolerance Separation at which the shapes are considered touching. Must be greater than zero
+ * \return Time in [0, 1] at which the separation first drops to tolerance, or nullopt if it never does.
+ * If max_iterations runs out first, the time reached so far with converged false: a fast object may still hit later.
+ */
+template <class Distance>
+[[nodiscard]] std::optional<ToiResult> TimeOfImpact(const Transform& a0, const Transform& a1, Float radius_a,
+                                                const Transform& b0, const Transform& b1, Float radius_b,
+                                                Distance&& distance, Float tolerance = 1e-3_f,
+                                                size_t max_iterations = 32)
+{
+    assert(tolerance > 0);
+
+    struct Motion
+    {
+        Transform start;
+        Vec3 translation;
+        UVec3 axis = UVec3::Up(); // Arbitrary if angle is 0
+        Rad angle;
+
+        Motion(const Transform& from, const Transform& to) noexcept
+            : start{from}, translation{to.pos - from.pos}
+        {
+            // Shortest rotation from `from` to `to`
+            auto delta = to.rot * *from.rot;
+            if (delta.s < 0)
+                delta = {-delta.v, -delta.s};
+
+            if (const auto u = delta.v.Unit())
+            {
+                axis = *u;
+                angle = Rad{2 * std::atan2(delta.v.Len(), delta.s)};
+            }
+        }
+
+        [[nodiscard]] Transform At(Float t) const noexcept
+        {
+            return {start.pos + translation * t, Quat{axis, angle * t} * start.rot, start.scale};
+        }
+    };
+
+    const Motion a{a0, a1}, b{b0, b1};
+
+    // Bound of approach speed over the whole motion
+    const auto speed = (a.translation - b.translation).Len() + a.angle.Get() * radius_a + b.angle.Get() * radius_b;
+
+    Float t = 0;
+    for (size_t i = 0; i < max_iterations; ++i)
+    {
+        const Float dist = distance(a.At(t), b.At(t));
+        if (dist <= tolerance)
+            return ToiResult{t, true};
+
+        if (speed <= 0)
+            return std::nullopt;
+
+        t += dist / speed;
+        if (t > 1)
+            return std::nullopt;
+    }
+    return ToiResult{t, false};
+}
+}
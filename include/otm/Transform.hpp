@@ -1,5 +1,6 @@
 #pragma once
 #include "Geometry.hpp"
+#include <algorithm>
 
 namespace otm
 {
@@ -8,7 +9,7 @@ namespace otm
 		static const Transform identity;
 		
 		Vec3 pos;
-		Quat rot;
+		Quat rot; // Must be normalized
 		Vec3 scale = Vec3::One();
 
 		constexpr Transform() noexcept = default;
@@ -20,21 +21,229 @@ namespace otm
 		{
 		}
 
+		/**
+		 * \brief Decompose a matrix without shear, i.e. made by ToMatrix(). Scale is the length of each row and rotation is
+		 * of the rows normalized. A mirroring matrix gets all of its scale negated.
+		 * Use DecomposeTransforms() with Decomposition::kPolar for matrices with shear.
+		 */
 		explicit Transform(const Mat4& m) noexcept
-			:pos{m[3]}, scale{m.Row<3>(0).Len(), m.Row<3>(1).Len(), m.Row<3>(2).Len()}
+			:pos{m[3]}
 		{
-			Mat3 rm{m};
-			rm[0] /= scale[0];
-			rm[1] /= scale[1];
-			rm[2] /= scale[2];
-			rot = Quat{rm};
+			const auto &a = m[0], &b = m[1], &c = m[2];
+			const auto det = a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0])
+				+ a[2] * (b[0] * c[1] - b[1] * c[0]);
+			const auto sign = det < 0 ? -1_f : 1_f;
+			scale = {
+				sign * std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]),
+				sign * std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]),
+				sign * std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2])
+			};
+
+			const auto x = 1 / scale[0], y = 1 / scale[1], z = 1 / scale[2];
+			rot = Quat{Mat3{a[0] * x, a[1] * x, a[2] * x, b[0] * y, b[1] * y, b[2] * y, c[0] * z, c[1] * z, c[2] * z}};
 		}
 
+		// Same as MakeScale<4>(scale) * MakeRotation<4>(rot) * MakeTranslation(pos)
 		[[nodiscard]] constexpr Mat4 ToMatrix() const noexcept
 		{
-			return MakeScale<4>(scale) * MakeRotation<4>(rot) * MakeTranslation(pos);
+			return Mat4::Identity(ToAffine());
+		}
+
+		// 4x3 affine matrix. Same as Mat4x3{ToMatrix()}
+		[[nodiscard]] constexpr Mat4x3 ToAffine() const noexcept
+		{
+			// Rows of MakeRotation(rot) times scale, written out: going through Mat3 and scaling rows costs a lot more
+			const auto& [x, y, z] = rot.v.data;
+			const auto& w = rot.s;
+			const auto& [sx, sy, sz] = scale.data;
+			return {
+				(1 - 2 * (y * y + z * z)) * sx, 2 * (x * y + w * z) * sx, 2 * (x * z - w * y) * sx,
+				2 * (x * y - w * z) * sy, (1 - 2 * (x * x + z * z)) * sy, 2 * (y * z + w * x) * sy,
+				2 * (x * z + w * y) * sz, 2 * (y * z - w * x) * sz, (1 - 2 * (x * x + y * y)) * sz,
+				pos[0], pos[1], pos[2]
+			};
+		}
+
+		// Scale, rotate, then translate. Same as TransformPoint(p, ToMatrix())
+		[[nodiscard]] Vec3 TransformPoint(const Vec3& p) const noexcept { return TransformVector(p) + pos; }
+		
+		// Scale then rotate. Translation is ignored
+		[[nodiscard]] Vec3 TransformVector(const Vec3& v) const noexcept { return (v * scale).RotatedByUnit(rot); }
+		
+		[[nodiscard]] Vec3 InverseTransformPoint(const Vec3& p) const noexcept { return InverseTransformVector(p - pos); }
+		[[nodiscard]] Vec3 InverseTransformVector(const Vec3& v) const noexcept { return v.RotatedByUnit(*rot) * InvScale(); }
+
+		/**
+		 * \brief Inverse transform
+		 * \note Exact only if scale is uniform; rotation and non-uniform scale can't be reordered without shear.
+		 */
+		[[nodiscard]] Transform Inverse() const noexcept
+		{
+			const auto inv_scale = InvScale();
+			const auto inv_rot = *rot;
+			return {-pos.RotatedByUnit(inv_rot) * inv_scale, inv_rot, inv_scale};
 		}
+
+		/**
+		 * \brief Apply this, then b. Same as Transform{ToMatrix() * b.ToMatrix()}
+		 * \note Exact only if b.scale is uniform; otherwise the result would need shear.
+		 */
+		[[nodiscard]] Transform operator*(const Transform& b) const noexcept
+		{
+			return {b.TransformPoint(pos), b.rot * rot, scale * b.scale};
+		}
+
+		Transform& operator*=(const Transform& b) noexcept { return *this = *this * b; }
+
+	private:
+		[[nodiscard]] constexpr Vec3 InvScale() const noexcept { return {1 / scale[0], 1 / scale[1], 1 / scale[2]}; }
 	};
 
 	inline const Transform Transform::identity;
+
+	/**
+	 * \brief How DecomposeTransforms() separates rotation from scale
+	 */
+	enum class Decomposition
+	{
+		// Same as Transform(const Mat4&). Matrices with shear get a rotation that isn't quite right
+		kNoShear,
+
+		// Rotation is the one nearest to the linear part, from its polar decomposition, and scale is along its axes.
+		// Shear is dropped. About twice the cost of kNoShear
+		kPolar,
+	};
+
+	namespace detail
+	{
+		/**
+		 * \brief Quaternion(const Mat3&), Pack::size matrices at once
+		 * \param m Rows of rotation matrices
+		 * \return (x, y, z, w)
+		 */
+		template <class Pack>
+		[[nodiscard]] Vector<Pack, 4> QuatFromRotation(const Vector<Pack, 3> (&m)[3]) noexcept
+		{
+			const auto one = Pack::Set1(1);
+			const auto dx = one + m[0][0] - m[1][1] - m[2][2];
+			const auto dy = one - m[0][0] + m[1][1] - m[2][2];
+			const auto dz = one - m[0][0] - m[1][1] + m[2][2];
+			const auto dw = one + m[0][0] + m[1][1] + m[2][2];
+			const auto p01 = m[0][1] + m[1][0], p02 = m[0][2] + m[2][0], p12 = m[1][2] + m[2][1];
+			const auto d12 = m[1][2] - m[2][1], d20 = m[2][0] - m[0][2], d01 = m[0][1] - m[1][0];
+
+			// Row with the larger diagonal of each pair, then of the two winners
+			const auto Pick = [](Pack da, Pack db, const Vector<Pack, 4>& a, const Vector<Pack, 4>& b, Pack& d)
+			{
+				Vector<Pack, 4> r;
+				for (size_t c = 0; c < 4; ++c)
+					r[c] = SelectGreater(da, db, a[c], b[c]);
+				d = Max(da, db);
+				return r;
+			};
+
+			Pack d_xy, d_zw, d;
+			const auto xy = Pick(dx, dy, {dx, p01, p02, d12}, {p01, dy, p12, d20}, d_xy);
+			const auto zw = Pick(dz, dw, {p02, p12, dz, d01}, {d12, d20, d01, dw}, d_zw);
+			const auto q = Pick(d_xy, d_zw, xy, zw, d);
+			return q * (Pack::Set1(0.5) / Sqrt(d));
+		}
+
+		/**
+		 * \brief Replace nonsingular matrices with positive determinant by their orthogonal polar factor, with Newton's
+		 * iteration R = (g * R + R^-T / g) / 2 scaled by g = sqrt(|R^-T| / |R|) in Frobenius norm. The scaling makes it
+		 * converge to float precision in a few iterations unless the matrix is nearly singular.
+		 */
+		template <class Pack>
+		void PolarRotation(Vector<Pack, 3> (&r)[3], size_t iterations = 6) noexcept
+		{
+			const auto half = Pack::Set1(0.5);
+			for (size_t iter = 0; iter < iterations; ++iter)
+			{
+				// R^-T is the cofactor matrix divided by the determinant
+				const Vector<Pack, 3> c[3]{r[1] ^ r[2], r[2] ^ r[0], r[0] ^ r[1]};
+				const auto det = r[0] | c[0];
+				const auto norm_r = (r[0] | r[0]) + (r[1] | r[1]) + (r[2] | r[2]);
+				const auto norm_c = (c[0] | c[0]) + (c[1] | c[1]) + (c[2] | c[2]);
+				const auto g = Sqrt(Sqrt(norm_c / (det * det * norm_r)));
+				const auto a = half * g, b = half / (g * det);
+				for (size_t i = 0; i < 3; ++i)
+					r[i] = r[i] * a + c[i] * b;
+			}
+		}
+	}
+
+	/**
+	 * \brief Decompose matrices into transforms, Pack::size at a time and without data-dependent branches.
+	 * A mirroring matrix gets all of its scale negated.
+	 * \param in Matrices made of scale, rotation and translation, possibly with shear in Decomposition::kPolar mode.
+	 * The upper 3x3 must be nonsingular and the last column is ignored
+	 * \param out Output transforms
+	 * \param count Number of matrices
+	 */
+	inline void DecomposeTransforms(const Mat4* in, Transform* out, size_t count,
+		Decomposition mode = Decomposition::kNoShear) noexcept
+	{
+		using Pack = detail::Pack<Float>;
+		constexpr auto W = Pack::size;
+
+		const auto zero = Pack::Set1(0), one = Pack::Set1(1);
+		for (size_t i = 0; i < count; i += W)
+		{
+			// Rows of W matrices, one per lane. Lanes past the end get the identity.
+			const auto n = std::min(W, count - i);
+			Float lanes[12][W];
+			for (size_t l = 0; l < W; ++l)
+			{
+				const auto& m = l < n ? in[i + l] : Mat4::identity;
+				for (size_t r = 0; r < 4; ++r)
+					for (size_t c = 0; c < 3; ++c)
+						lanes[r * 3 + c][l] = m[r][c];
+			}
+
+			Vector<Pack, 3> rows[3];
+			for (size_t r = 0; r < 3; ++r)
+				for (size_t c = 0; c < 3; ++c)
+					rows[r][c] = Pack::Load(lanes[r * 3 + c]);
+
+			// Mirroring is moved into the scale so the rotation part has a positive determinant
+			const auto sign = SelectGreater(zero, rows[0] | (rows[1] ^ rows[2]), -one, one);
+			for (auto& row : rows)
+				row *= sign;
+
+			Vector<Pack, 3> scale;
+			if (mode == Decomposition::kPolar)
+			{
+				const Vector<Pack, 3> linear[3]{rows[0], rows[1], rows[2]};
+				detail::PolarRotation(rows);
+				for (size_t r = 0; r < 3; ++r)
+					scale[r] = (linear[r] | rows[r]) * sign;
+			}
+			else
+			{
+				for (size_t r = 0; r < 3; ++r)
+				{
+					const auto len = Sqrt(rows[r] | rows[r]);
+					rows[r] *= one / len;
+					scale[r] = len * sign;
+				}
+			}
+
+			const auto rot = detail::QuatFromRotation(rows);
+			Float results[7][W];
+			for (size_t c = 0; c < 4; ++c)
+				rot[c].Store(results[c]);
+			for (size_t c = 0; c < 3; ++c)
+				scale[c].Store(results[4 + c]);
+
+			for (size_t l = 0; l < n; ++l)
+			{
+				out[i + l] = {
+					{lanes[9][l], lanes[10][l], lanes[11][l]},
+					{results[0][l], results[1][l], results[2][l], results[3][l]},
+					{results[4][l], results[5][l], results[6][l]}
+				};
+			}
+		}
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Angle.hpp"
 #include "Basic.hpp"
+#include "Simd.hpp"
 #include <cassert>
 #include <functional>
 #include <optional>
@@ -97,6 +98,17 @@ struct VecBase<T, 3> : VecBase0<T, 3>
     template <class U>
     constexpr auto operator^(const Vector<U, 3>& b) const noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (kSimdVec<T, 3> && std::is_same_v<T, U>)
+        {
+            if (!IsConstantEvaluated())
+            {
+                Vector<T, 3> c;
+                SimdStore<3>(c.data, SimdCross(SimdLoad<3>(this->data), SimdLoad<3>(b.data)));
+                return c;
+            }
+        }
+#endif
         auto& a = this->data;
         return Vector{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
     }
@@ -108,10 +120,14 @@ struct VecBase<T, 3> : VecBase0<T, 3>
     }
 
     template <class F>
-    [[nodiscard]] Vector<std::common_type_t<T, F>, 3> RotatedBy(const Quaternion<F>& q) const noexcept;
+    [[nodiscard]] constexpr Vector<std::common_type_t<T, F>, 3> RotatedBy(const Quaternion<F>& q) const noexcept;
+
+    // Faster than RotatedBy() but q must be normalized
+    template <class F>
+    [[nodiscard]] constexpr Vector<std::common_type_t<T, F>, 3> RotatedByUnit(const Quaternion<F>& q) const noexcept;
 
     template <class F>
-    void RotateBy(const Quaternion<F>& q) noexcept;
+    constexpr void RotateBy(const Quaternion<F>& q) noexcept;
 };
 
 template <class T, size_t L>
@@ -370,6 +386,17 @@ struct Vector : detail::VecBase<T, L>
     bool TryNormalize() noexcept
     {
         static_assert(std::is_same_v<T, CommonFloat<T>>, "Can't use Normalize() for this type. Use Unit() instead.");
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            const auto v = detail::SimdLoad<L>(this->data);
+            const auto lensqr = detail::SimdDot(v, v);
+            if (_mm_cvtss_f32(lensqr) <= kSmallNumV<T>)
+                return false;
+            detail::SimdStore<L>(this->data, _mm_div_ps(v, _mm_sqrt_ps(lensqr)));
+            return true;
+        }
+#endif
         const auto lensqr = LenSqr();
         if (lensqr <= kSmallNumV<T>)
             return false;
@@ -472,21 +499,61 @@ struct Vector : detail::VecBase<T, L>
 
     constexpr Vector& operator+=(const Vector& v) noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(this->data, _mm_add_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return *this;
+            }
+        }
+#endif
         return Transform(v, std::plus<>{});
     }
 
     constexpr Vector& operator-=(const Vector& v) noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(this->data, _mm_sub_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return *this;
+            }
+        }
+#endif
         return Transform(v, std::minus<>{});
     }
 
     constexpr Vector& operator*=(const Vector& v) noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(this->data, _mm_mul_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return *this;
+            }
+        }
+#endif
         return Transform(v, std::multiplies<>{});
     }
 
     constexpr Vector& operator*=(T f) noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(this->data, _mm_mul_ps(detail::SimdLoad<L>(this->data), _mm_set1_ps(f)));
+                return *this;
+            }
+        }
+#endif
         return Transform([f](T v) -> T
         {
             return v * f;
@@ -495,6 +562,16 @@ struct Vector : detail::VecBase<T, L>
 
     constexpr Vector& operator/=(T f) noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(this->data, _mm_div_ps(detail::SimdLoad<L>(this->data), _mm_set1_ps(f)));
+                return *this;
+            }
+        }
+#endif
         return Transform([f](T v) -> T
         {
             return v / f;
@@ -505,6 +582,16 @@ struct Vector : detail::VecBase<T, L>
     constexpr auto operator+(const Vector<U, L>& v) const noexcept
     {
         Vector<std::common_type_t<T, U>, L> r;
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L> && std::is_same_v<T, U>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(r.data, _mm_add_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return r;
+            }
+        }
+#endif
         for (size_t i = 0; i < L; ++i)
             r[i] = (*this)[i] + v[i];
         return r;
@@ -514,6 +601,16 @@ struct Vector : detail::VecBase<T, L>
     constexpr auto operator-(const Vector<U, L>& v) const noexcept
     {
         Vector<std::common_type_t<T, U>, L> r;
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L> && std::is_same_v<T, U>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(r.data, _mm_sub_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return r;
+            }
+        }
+#endif
         for (size_t i = 0; i < L; ++i)
             r[i] = (*this)[i] - v[i];
         return r;
@@ -523,6 +620,16 @@ struct Vector : detail::VecBase<T, L>
     constexpr auto operator*(const Vector<U, L>& v) const noexcept
     {
         Vector<std::common_type_t<T, U>, L> r;
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L> && std::is_same_v<T, U>)
+        {
+            if (!detail::IsConstantEvaluated())
+            {
+                detail::SimdStore<L>(r.data, _mm_mul_ps(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+                return r;
+            }
+        }
+#endif
         for (size_t i = 0; i < L; ++i)
             r[i] = (*this)[i] * v[i];
         return r;
@@ -549,6 +656,13 @@ struct Vector : detail::VecBase<T, L>
     template <class T2>
     constexpr std::common_type_t<T, T2> operator|(const Vector<T2, L>& v) const noexcept
     {
+#if OTM_SIMD_SSE
+        if constexpr (detail::kSimdVec<T, L> && std::is_same_v<T, T2>)
+        {
+            if (!detail::IsConstantEvaluated())
+                return _mm_cvtss_f32(detail::SimdDot(detail::SimdLoad<L>(this->data), detail::SimdLoad<L>(v.data)));
+        }
+#endif
         std::common_type_t<T, T2> t{};
         for (size_t i = 0; i < L; ++i)
             t += (*this)[i] * v[i];
@@ -979,6 +1093,18 @@ private:
 template <class T, size_t L>
 std::optional<UnitVec<CommonFloat<T>, L>> Vector<T, L>::Unit() const noexcept
 {
+#if OTM_SIMD_SSE
+    if constexpr (detail::kSimdVec<T, L>)
+    {
+        const auto v = detail::SimdLoad<L>(this->data);
+        const auto lensqr = detail::SimdDot(v, v);
+        if (_mm_cvtss_f32(lensqr) <= kSmallNumV<T>)
+            return {};
+        Vector u;
+        detail::SimdStore<L>(u.data, _mm_div_ps(v, _mm_sqrt_ps(lensqr)));
+        return UnitVec{u};
+    }
+#endif
     const auto lensqr = LenSqr();
     if (lensqr <= kSmallNumV<T>)
         return {};
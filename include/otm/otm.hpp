@@ -2,3 +2,15 @@
 #include "otm/Angle.hpp"
 #include "otm/Transform.hpp"
 #include "otm/Hash.hpp"
+#include "otm/SoA.hpp"
+#include "otm/Expr.hpp"
+#include "otm/GeometrySoA.hpp"
+#include "otm/BVH.hpp"
+#include "otm/BoundingVolume.hpp"
+#include "otm/HashGrid.hpp"
+#include "otm/SweepAndPrune.hpp"
+#include "otm/TimeOfImpact.hpp"
+#include "otm/GJK.hpp"
+#include "otm/RayPacket.hpp"
+#include "otm/Skeleton.hpp"
+#include "otm/DualQuat.hpp"
@@ -29,6 +29,11 @@ struct Quaternion;
 
 using Quat = Quaternion<Float>;
 
+template <class T>
+struct DualQuaternion;
+
+using DualQuat = DualQuaternion<Float>;
+
 
 template <class T, size_t L>
 struct Vector;
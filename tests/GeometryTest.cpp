@@ -1,4 +1,12 @@
 #include <gtest/gtest.h>
+#include "otm/BoundingVolume.hpp"
+#include "otm/DualQuat.hpp"
+#include "otm/GJK.hpp"
+#include "otm/GeometrySoA.hpp"
+#include "otm/RayPacket.hpp"
+#include "otm/Skeleton.hpp"
+#include "otm/SoA.hpp"
+#include "otm/TimeOfImpact.hpp"
 #include "otm/Transform.hpp"
 
 namespace otm
@@ -68,6 +76,183 @@ namespace otm
 		}
 	}
 
+	TEST(Geometry, QuatInterp)
+	{
+		const Quat a{UVec3::Up(), 10_deg}, b{UVec3::Up(), 100_deg};
+		EXPECT_TRUE(IsNearlyEqual(Slerp(a, b, 0_f), a));
+		EXPECT_TRUE(IsNearlyEqual(Slerp(a, b, 1_f), b));
+		EXPECT_TRUE(IsNearlyEqual(Slerp(a, b, 0.25_f), Quat{UVec3::Up(), 32.5_deg}));
+		EXPECT_TRUE(IsNearlyEqual(Nlerp(a, b, 0.5_f), Quat{UVec3::Up(), 55_deg}));
+
+		// Shorter path whichever sign b has
+		EXPECT_TRUE(IsEquivalent(Slerp(a, -b, 0.25_f), Quat{UVec3::Up(), 32.5_deg}));
+		EXPECT_TRUE(IsEquivalent(Nlerp(a, -b, 0.5_f), Quat{UVec3::Up(), 55_deg}));
+		EXPECT_TRUE(IsEquivalent(SlerpFast(a, -b, 0.25_f), Quat{UVec3::Up(), 32.5_deg}, 1e-4_f));
+
+		// Nearly equal inputs
+		EXPECT_TRUE(IsNearlyEqual(Slerp(a, a, 0.3_f), a));
+
+		std::vector<Vec4> qa(37), qb(37);
+		for (size_t i = 0; i < qa.size(); ++i)
+		{
+			const auto x = Quat::Rand(), y = Quat::Rand();
+			const auto alpha = Rand(0_f, 1_f);
+			const auto exact = Slerp(x, y, alpha);
+			ASSERT_TRUE(IsNearlyEqual(exact.Len(), 1_f));
+			ASSERT_TRUE(IsNearlyEqual(SlerpFast(x, y, alpha), exact, 1e-4_f));
+			qa[i] = {x.v[0], x.v[1], x.v[2], x.s};
+			qb[i] = {y.v[0], y.v[1], y.v[2], y.s};
+		}
+
+		const SoA<Vec4> sa{qa.data(), qa.size()}, sb{qb.data(), qb.size()};
+		SoA<Vec4> slerp, nlerp;
+		SlerpFast(sa, sb, 0.3_f, slerp);
+		Nlerp(sa, sb, 0.3_f, nlerp);
+		ASSERT_EQ(slerp.size(), qa.size());
+		for (size_t i = 0; i < qa.size(); ++i)
+		{
+			const Quat x{qa[i]}, y{qb[i]};
+			EXPECT_TRUE(IsNearlyEqual(Quat{slerp[i]}, SlerpFast(x, y, 0.3_f), 1e-5_f));
+			EXPECT_TRUE(IsNearlyEqual(Quat{nlerp[i]}, Nlerp(x, y, 0.3_f), 1e-5_f));
+		}
+	}
+
+	TEST(Geometry, Squad)
+	{
+		const Quat keys[4]{
+			Quat{UVec3::Up(), 0_deg},
+			Quat{UVec3::Up(), 40_deg},
+			Quat{UVec3::Right(), 30_deg} * Quat{UVec3::Up(), 80_deg},
+			Quat{UVec3::Up(), 120_deg}
+		};
+		const auto c1 = SquadControl(keys[0], keys[1], keys[2]);
+		const auto c2 = SquadControl(keys[1], keys[2], keys[3]);
+		EXPECT_TRUE(IsNearlyEqual(Squad(keys[1], c1, c2, keys[2], 0_f), keys[1]));
+		EXPECT_TRUE(IsNearlyEqual(Squad(keys[1], c1, c2, keys[2], 1_f), keys[2]));
+		EXPECT_TRUE(IsNearlyEqual(Squad(keys[1], c1, c2, keys[2], 0.4_f).Len(), 1_f));
+
+		// Keys evenly spaced on one axis need no correction: same as Slerp
+		const Quat even[3]{Quat{UVec3::Up(), 10_deg}, Quat{UVec3::Up(), 30_deg}, Quat{UVec3::Up(), 50_deg}};
+		const auto c = SquadControl(even[0], even[1], even[2]);
+		EXPECT_TRUE(IsNearlyEqual(c, even[1]));
+		EXPECT_TRUE(IsNearlyEqual(Squad(even[0], even[0], c, even[1], 0.3_f), Slerp(even[0], even[1], 0.3_f), 1e-3_f));
+
+		// Angular velocity is continuous across a key
+		const auto c0 = SquadControl(keys[0], keys[0], keys[1]);
+		const auto h = 1e-2_f;
+		const auto before = Squad(keys[0], c0, c1, keys[1], 1 - h);
+		const auto after = Squad(keys[1], c1, c2, keys[2], h);
+		const auto Angle = [](const Quat& p, const Quat& q) { return 2 * std::acos(std::min(std::abs(p | q), 1_f)); };
+		EXPECT_NEAR(Angle(before, keys[1]), Angle(keys[1], after), 2e-3_f);
+	}
+
+	TEST(Geometry, QuatEuler)
+	{
+		const Quat roll{UVec3::Forward(), 10_deg}, pitch{UVec3::Right(), 20_deg}, yaw{UVec3::Up(), 30_deg};
+		const EulerAngles<Float> angles{10_deg, 20_deg, 30_deg};
+		EXPECT_TRUE(IsEquivalent(Quat::FromEuler(angles), yaw * pitch * roll));
+		EXPECT_TRUE(IsEquivalent(Quat::FromEuler(angles, EulerOrder::kZYX), roll * pitch * yaw));
+		EXPECT_TRUE(IsEquivalent(Quat::FromEuler(angles, EulerOrder::kYZX), roll * yaw * pitch));
+
+		const auto back = Quat::FromEuler(angles, EulerOrder::kZXY).ToEuler(EulerOrder::kZXY);
+		EXPECT_TRUE(IsNearlyEqual(back.x.Get(), angles.x.Get()));
+		EXPECT_TRUE(IsNearlyEqual(back.y.Get(), angles.y.Get()));
+		EXPECT_TRUE(IsNearlyEqual(back.z.Get(), angles.z.Get()));
+
+		for (const auto order : {EulerOrder::kXYZ, EulerOrder::kXZY, EulerOrder::kYXZ, EulerOrder::kYZX,
+			EulerOrder::kZXY, EulerOrder::kZYX})
+		{
+			for (auto i = 0; i < 100; ++i)
+			{
+				const auto q = Quat::Rand();
+				ASSERT_TRUE(IsEquivalent(Quat::FromEuler(q.ToEuler(order), order), q, 1e-4_f));
+			}
+
+			// Gimbal lock: the middle rotation is a quarter turn either way
+			for (const auto middle : {90_deg, -90_deg})
+			{
+				Float a[3]{0.3_f, 0.3_f, 0.3_f};
+				a[detail::kEulerAxes[static_cast<size_t>(order)][1]] = Rad{middle}.Get();
+				const EulerAngles<Float> locked{Rad{a[0]}, Rad{a[1]}, Rad{a[2]}};
+				const auto q = Quat::FromEuler(locked, order);
+				ASSERT_TRUE(IsEquivalent(Quat::FromEuler(q.ToEuler(order), order), q, 1e-4_f));
+			}
+		}
+	}
+
+	TEST(Geometry, QuatFromTo)
+	{
+		EXPECT_TRUE(IsEquivalent(Quat::FromTo(UVec3::Forward(), UVec3::Right()), Quat{UVec3::Up(), 90_deg}));
+		EXPECT_TRUE(IsNearlyEqual(Quat::FromTo(UVec3::Up(), UVec3::Up()), Quat::identity));
+
+		for (const auto& from : {UVec3::Forward(), UVec3::Right(), UVec3::Up(), *Vec3{1, -2, 3}.Unit()})
+		{
+			const auto q = Quat::FromTo(from, *(-from.Get()).Unit());
+			EXPECT_TRUE(IsNearlyEqual(q.Len(), 1_f));
+			EXPECT_TRUE(IsNearlyEqual(from.Get().RotatedBy(q), -from.Get()));
+		}
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			const auto from = UVec3::Rand(), to = UVec3::Rand();
+			const auto q = Quat::FromTo(from, to);
+			ASSERT_TRUE(IsNearlyEqual(q.Len(), 1_f));
+			ASSERT_TRUE(IsNearlyEqual(from.Get().RotatedBy(q), to.Get(), 1e-4_f));
+
+			// Shortest arc: the axis is perpendicular to both
+			ASSERT_NEAR(q.v | from.Get(), 0_f, 1e-4_f);
+			ASSERT_NEAR(q.v | to.Get(), 0_f, 1e-4_f);
+		}
+	}
+
+	TEST(Geometry, QuatLookRotation)
+	{
+		EXPECT_TRUE(IsEquivalent(Quat::LookRotation(UVec3::Right()), Quat{UVec3::Up(), 90_deg}));
+		EXPECT_TRUE(IsEquivalent(Quat::LookRotation(UVec3::Backward()), Quat{UVec3::Up(), 180_deg}));
+		EXPECT_TRUE(IsEquivalent(Quat::LookRotation(UVec3::Forward(), UVec3::Right()), Quat{UVec3::Forward(), -90_deg}));
+
+		// Straight up: any roll will do
+		const auto q = Quat::LookRotation(UVec3::Up());
+		EXPECT_TRUE(IsNearlyEqual(Vec3::forward.RotatedBy(q), Vec3::up));
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			const auto forward = UVec3::Rand(), up = UVec3::Rand();
+			const auto r = Quat::LookRotation(forward, up);
+			const auto f = Vec3::forward.RotatedBy(r), u = Vec3::up.RotatedBy(r), right = Vec3::right.RotatedBy(r);
+			ASSERT_TRUE(IsNearlyEqual(r.Len(), 1_f));
+			ASSERT_TRUE(IsNearlyEqual(f, forward.Get(), 1e-4_f));
+
+			// Up is in the plane of forward and up, on the same side; right is perpendicular to that plane
+			ASSERT_NEAR(right | up.Get(), 0_f, 1e-4_f);
+			ASSERT_GE(u | up.Get(), 0_f);
+		}
+	}
+
+	TEST(Geometry, SwingTwist)
+	{
+		const Quat twist{UVec3::Up(), 40_deg}, swing{UVec3::Right(), 30_deg};
+		const auto [s, t] = (swing * twist).SwingTwist(UVec3::Up());
+		EXPECT_TRUE(IsEquivalent(s, swing));
+		EXPECT_TRUE(IsEquivalent(t, twist));
+
+		// No rotation about the axis
+		const auto [s2, t2] = Quat{UVec3::Right(), 180_deg}.SwingTwist(UVec3::Up());
+		EXPECT_TRUE(IsEquivalent(s2, Quat{UVec3::Right(), 180_deg}));
+		EXPECT_TRUE(IsNearlyEqual(t2, Quat::identity));
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			const auto q = Quat::Rand();
+			const auto axis = UVec3::Rand();
+			const auto [sw, tw] = q.SwingTwist(axis);
+			ASSERT_TRUE(IsNearlyEqual(sw * tw, q, 1e-4_f));
+			ASSERT_TRUE(IsNearlyEqual(tw.Len(), 1_f));
+			ASSERT_TRUE(IsNearlyEqual((tw.v ^ axis.Get()).Len(), 0_f, 1e-4_f));
+			ASSERT_NEAR(sw.v | axis.Get(), 0_f, 1e-4_f);
+		}
+	}
+
 	TEST(Geometry, DecompMatToTrsf)
 	{
 		for (auto i=0; i<100; ++i)
@@ -79,5 +264,985 @@ namespace otm
 			ASSERT_TRUE(IsEquivalent(trsf1.rot, trsf2.rot));
 			ASSERT_TRUE(IsNearlyEqual(trsf1.scale, trsf2.scale));
 		}
+
+		// Half turns have w = 0, so another row of the matrix has to give the quaternion
+		for (const auto& axis : {UVec3::Right(), UVec3::Up(), UVec3::Forward(), *Vec3{1, -2, 3}.Unit()})
+		{
+			const Quat q{axis, 180_deg};
+			EXPECT_TRUE(IsEquivalent(Quat{MakeRotation(q)}, q));
+		}
+
+		// Mirroring goes into the scale
+		const Transform mirrored{Vec3{1, 2, 3}, Quat{UVec3::Up(), 30_deg}, Vec3{-1, -2, -3}};
+		const Transform decomposed{mirrored.ToMatrix()};
+		EXPECT_TRUE(IsNearlyEqual(decomposed.scale, mirrored.scale));
+		EXPECT_TRUE(IsEquivalent(decomposed.rot, mirrored.rot));
+	}
+
+	TEST(Geometry, DecomposeTransforms)
+	{
+		constexpr size_t n = 37;
+		std::vector<Transform> transforms(n);
+		std::vector<Mat4> matrices(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			auto scale = Vec3::Rand(0.1, 10);
+			if (i % 5 == 0)
+				scale[i % 3] = -scale[i % 3];
+			transforms[i] = {Vec3::Rand(-100, 100), Quat::Rand(), scale};
+			matrices[i] = transforms[i].ToMatrix();
+		}
+
+		for (const auto mode : {Decomposition::kNoShear, Decomposition::kPolar})
+		{
+			std::vector<Transform> out(n);
+			DecomposeTransforms(matrices.data(), out.data(), n, mode);
+			for (size_t i = 0; i < n; ++i)
+			{
+				// Same matrix back, though mirroring may be moved to other axes
+				const Transform single{matrices[i]};
+				EXPECT_TRUE(IsNearlyEqual(out[i].pos, transforms[i].pos));
+				EXPECT_TRUE(IsNearlyEqual(out[i].ToMatrix(), matrices[i], 1e-3_f));
+				EXPECT_TRUE(IsNearlyEqual(out[i].scale, single.scale, 1e-3_f));
+				EXPECT_TRUE(IsEquivalent(out[i].rot, single.rot, 1e-4_f));
+			}
+		}
+
+		// Scale along the rotated axes plus some shear: polar decomposition still finds the rotation
+		for (size_t i = 0; i < n; ++i)
+		{
+			const auto rot = Quat::Rand();
+			Mat3 stretch;
+			for (size_t r = 0; r < 3; ++r)
+			{
+				stretch[r][r] = Rand(0.5_f, 2_f);
+				for (size_t c = 0; c < r; ++c)
+					stretch[r][c] = stretch[c][r] = Rand(-0.2_f, 0.2_f);
+			}
+			matrices[i] = Mat4::Identity(stretch * MakeRotation(rot));
+			matrices[i][3] = {1, 2, 3, 1};
+
+			Transform polar;
+			DecomposeTransforms(&matrices[i], &polar, 1, Decomposition::kPolar);
+			EXPECT_TRUE(IsEquivalent(polar.rot, rot, 1e-4_f));
+			EXPECT_TRUE(IsNearlyEqual(polar.scale, Vec3{stretch[0][0], stretch[1][1], stretch[2][2]}, 1e-4_f));
+			EXPECT_TRUE(IsNearlyEqual(polar.pos, Vec3{1, 2, 3}));
+		}
+	}
+
+	TEST(Geometry, Affine)
+	{
+		for (auto i=0; i<100; ++i)
+		{
+			const Transform ta{Vec3::Rand(-100, 100), Quat::Rand(), Vec3::Rand(0.1, 10)};
+			const Transform tb{Vec3::Rand(-100, 100), Quat::Rand(), Vec3::Rand(0.1, 10)};
+			const auto a = ta.ToAffine(), b = tb.ToAffine();
+			ASSERT_TRUE(IsNearlyEqual(a, Mat4x3{ta.ToMatrix()}, 1e-4_f));
+
+			const auto ab = MulAffine(a, b);
+			ASSERT_TRUE(IsNearlyEqual(Mat4::Identity(ab), ta.ToMatrix() * tb.ToMatrix(), 1e-2_f));
+
+			const auto p = Vec3::Rand(-10, 10);
+			ASSERT_TRUE(IsNearlyEqual(TransformPoint(p, a), TransformPoint(p, ta.ToMatrix()), 1e-3_f));
+
+			const auto inv = InvAffine(a);
+			ASSERT_TRUE(inv.has_value());
+			ASSERT_TRUE(IsNearlyEqual(TransformPoint(TransformPoint(p, a), *inv), p, 1e-3_f));
+
+			const auto inv_ns = InvAffineNoShear(a);
+			ASSERT_TRUE(inv_ns.has_value());
+			ASSERT_TRUE(IsNearlyEqual(*inv_ns, *inv, 1e-3_f));
+		}
+
+		EXPECT_FALSE(InvAffine(Mat4x3{}).has_value());
+		EXPECT_FALSE(InvAffineNoShear(Mat4x3{}).has_value());
+	}
+
+	TEST(Geometry, Skeleton)
+	{
+		// Two chains under one root: 0 -> 1 -> 3 -> 4 and 0 -> 2 -> 5
+		const int32_t parents[]{kNoParent, 0, 0, 1, 3, 2};
+		constexpr size_t n = std::size(parents);
+		EXPECT_TRUE(IsParentsFirst(parents, n));
+		const int32_t bad[]{kNoParent, 2, 0};
+		EXPECT_FALSE(IsParentsFirst(bad, 3));
+
+		Transform bind[n], pose[n];
+		for (size_t i = 0; i < n; ++i)
+		{
+			bind[i] = {Vec3::Rand(-2, 2), Quat::Rand(), Vec3::Rand(0.5, 2)};
+			pose[i] = {Vec3::Rand(-2, 2), Quat::Rand(), Vec3::Rand(0.5, 2)};
+		}
+
+		Mat4x3 inverse_bind[n], model[n], palette[n];
+		InverseBindPoses(parents, bind, inverse_bind, n);
+		EvaluatePose(parents, pose, inverse_bind, model, palette, n);
+
+		Mat4 bind_model[n], pose_model[n];
+		for (size_t i = 0; i < n; ++i)
+		{
+			bind_model[i] = bind[i].ToMatrix();
+			pose_model[i] = pose[i].ToMatrix();
+			if (parents[i] != kNoParent)
+			{
+				bind_model[i] = bind_model[i] * bind_model[parents[i]];
+				pose_model[i] = pose_model[i] * pose_model[parents[i]];
+			}
+
+			EXPECT_TRUE(IsNearlyEqual(Mat4::Identity(model[i]), pose_model[i], 1e-3_f));
+			const auto p = Vec3::Rand(-1, 1);
+			EXPECT_TRUE(IsNearlyEqual(TransformPoint(TransformPoint(p, bind_model[i]), palette[i]),
+				TransformPoint(p, pose_model[i]), 1e-3_f));
+		}
+
+		Mat4x3 model2[n], palette2[n];
+		LocalToModel(parents, pose, model2, n);
+		SkinningPalette(model2, inverse_bind, palette2, n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			EXPECT_TRUE(IsNearlyEqual(model2[i], model[i]));
+			EXPECT_TRUE(IsNearlyEqual(palette2[i], palette[i]));
+		}
+
+		// Bind pose skins to identity
+		EvaluatePose(parents, bind, inverse_bind, model, palette, n);
+		for (size_t i = 0; i < n; ++i)
+			EXPECT_TRUE(IsNearlyEqual(Mat4::Identity(palette[i]), Mat4::identity, 1e-4_f));
+	}
+
+	TEST(Geometry, DualQuat)
+	{
+		EXPECT_TRUE(IsNearlyEqual(DualQuat{}.TransformPoint(Vec3{1, 2, 3}), Vec3{1, 2, 3}));
+		EXPECT_TRUE(IsNearlyEqual(DualQuat{Vec3{1, 2, 3}}.Translation(), Vec3{1, 2, 3}));
+
+		for (auto i=0; i<100; ++i)
+		{
+			const Transform ta{Vec3::Rand(-10, 10), Quat::Rand()};
+			const Transform tb{Vec3::Rand(-10, 10), Quat::Rand()};
+			const DualQuat a{ta}, b{tb};
+			const auto p = Vec3::Rand(-10, 10);
+
+			ASSERT_TRUE(IsNearlyEqual(a.Translation(), ta.pos, 1e-4_f));
+			ASSERT_TRUE(IsNearlyEqual(a.TransformPoint(p), ta.TransformPoint(p), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(a.TransformVector(p), ta.TransformVector(p), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(a.ToTransform().ToMatrix(), ta.ToMatrix(), 1e-3_f));
+
+			const auto ab = a * b;
+			ASSERT_TRUE(IsNearlyEqual(ab.TransformPoint(p), (ta * tb).TransformPoint(p), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual((a * a.Inverse()).TransformPoint(p), p, 1e-3_f));
+
+			// Unnormalized sum stands for the same transform once normalized
+			const auto scaled = (a * 3_f).Normalized();
+			ASSERT_TRUE(IsNearlyEqual(scaled, a, 1e-4_f));
+		}
+	}
+
+	TEST(Geometry, DualQuatSkinning)
+	{
+		const DualQuat palette[]{
+			DualQuat{Quat{UVec3::Up(), 0_deg}, Vec3{0, 0, 0}},
+			DualQuat{Quat{UVec3::Up(), 90_deg}, Vec3{1, 0, 0}},
+			DualQuat{Quat{UVec3::Right(), 60_deg}, Vec3{0, 2, 0}},
+			-DualQuat{Quat{UVec3::Up(), 80_deg}, Vec3{1, 0, 0}} // Other hemisphere
+		};
+
+		// A single influence is the bone's transform
+		const uint32_t one_bone[]{2};
+		const Float full[]{1};
+		EXPECT_TRUE(IsNearlyEqual(Blend(palette, one_bone, full, 1), palette[2]));
+
+		// Halfway between two rotations about one axis, whichever sign the second has
+		const uint32_t pair[]{0, 1}, pair_flipped[]{0, 3};
+		const Float half[]{0.5f, 0.5f};
+		EXPECT_TRUE(IsNearlyEqual(Blend(palette, pair, half, 2).real, Quat{UVec3::Up(), 45_deg}));
+		EXPECT_TRUE(IsNearlyEqual(Blend(palette, pair_flipped, half, 2).real, Quat{UVec3::Up(), 40_deg}));
+
+		constexpr size_t n = 37;
+		std::vector<uint32_t> bones(n * 4);
+		std::vector<Float> weights(n * 4);
+		std::vector<Vec3> points(n), skinned(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			Float sum = 0;
+			for (size_t k = 0; k < 4; ++k)
+			{
+				bones[i * 4 + k] = Rand<uint32_t>(0, 3);
+				weights[i * 4 + k] = k == 3 ? 0 : Rand(0.1_f, 1_f);
+				sum += weights[i * 4 + k];
+			}
+			for (size_t k = 0; k < 4; ++k)
+				weights[i * 4 + k] /= sum;
+			points[i] = Vec3::Rand(-5, 5);
+		}
+
+		SkinPoints<4>(palette, bones.data(), weights.data(), points.data(), skinned.data(), n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const auto expected = Blend(palette, &bones[i * 4], &weights[i * 4], 4).TransformPoint(points[i]);
+			EXPECT_TRUE(IsNearlyEqual(skinned[i], expected, 1e-4_f));
+		}
+
+		// In place
+		SkinPoints<4>(palette, bones.data(), weights.data(), points.data(), points.data(), n);
+		for (size_t i = 0; i < n; ++i)
+			EXPECT_TRUE(IsNearlyEqual(points[i], skinned[i]));
+	}
+
+	TEST(Geometry, TransformOps)
+	{
+		for (auto i=0; i<100; ++i)
+		{
+			const Transform ta{Vec3::Rand(-100, 100), Quat::Rand(), Vec3::Rand(0.1, 10)};
+			const Transform tb{Vec3::Rand(-100, 100), Quat::Rand(), Vec3{All{}, Rand(0.1_f, 10_f)}};
+			const auto p = Vec3::Rand(-10, 10);
+
+			ASSERT_TRUE(IsNearlyEqual(ta.TransformPoint(p), TransformPoint(p, ta.ToMatrix()), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(ta.TransformVector(p), TransformDirection(p, ta.ToMatrix()), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(ta.InverseTransformPoint(ta.TransformPoint(p)), p, 1e-3_f));
+
+			const auto tab = ta * tb;
+			ASSERT_TRUE(IsNearlyEqual(tab.ToMatrix(), ta.ToMatrix() * tb.ToMatrix(), 1e-2_f));
+
+			const auto tbi = tb.Inverse();
+			ASSERT_TRUE(IsNearlyEqual(tbi.TransformPoint(tb.TransformPoint(p)), p, 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(tbi.ToMatrix(), *tb.ToMatrix().Inv(), 1e-3_f));
+		}
+	}
+
+	TEST(Geometry, Rotate)
+	{
+		constexpr Quat q{0.1130857f, -0.1826944f, -0.2182483f, 0.9519464f};
+		constexpr Vec3 v{1, -2, 3};
+		constexpr auto vr = v.RotatedBy(q);
+		EXPECT_TRUE(IsNearlyEqual(vr, (q * Quat{v, 0} * ~q).v));
+		EXPECT_TRUE(IsNearlyEqual(v.RotatedBy(q * 3), vr));
+		EXPECT_TRUE(IsNearlyEqual(v.RotatedByUnit(q), vr));
+
+		Vec3 vs[11];
+		for (auto& x : vs) x = Vec3::Rand(-10, 10);
+		Vec3 out[11];
+		const auto qr = Quat::Rand();
+		RotateVectors(vs, out, 11, qr);
+		for (auto i=0; i<11; ++i)
+			ASSERT_TRUE(IsNearlyEqual(out[i], vs[i].RotatedBy(qr), 1e-4_f));
+
+		RotateVectors(vs, vs, 11, qr);
+		for (auto i=0; i<11; ++i)
+			ASSERT_TRUE(IsNearlyEqual(out[i], vs[i]));
+	}
+
+	TEST(Geometry, Primitives)
+	{
+		constexpr AABB b1{Vec3{-1, -1, -1}, Vec3{1, 1, 1}};
+		constexpr AABB b2{Vec3{0.5f, 0.5f, 0.5f}, Vec3{2, 2, 2}};
+		constexpr AABB b3{Vec3{1.5f, -1, -1}, Vec3{2, 1, 1}};
+		static_assert(IsOverlapped(b1, b2));
+		static_assert(!IsOverlapped(b1, b3));
+		static_assert(IsOverlapped(Sphere{Vec3{1.5f, 0, 0}, 0.6f}, b1));
+		static_assert(!IsOverlapped(Sphere{Vec3{1.5f, 1.5f, 0}, 0.6f}, b1));
+
+		// Touching counts as overlap for the primitives, but not for two spheres
+		static_assert(IsOverlapped(Sphere{Vec3{2, 0, 0}, 1}, b1));
+		static_assert(IsOverlapped(Sphere{Vec3{}, 1}, Sphere{Vec3{1.5f, 0, 0}, 1}));
+		static_assert(!IsOverlapped(Sphere{Vec3{}, 1}, Sphere{Vec3{2, 0, 0}, 1}));
+
+		auto b4 = AABB::Empty();
+		EXPECT_FALSE(b4.IsValid());
+		b4.Merge(b1);
+		b4.Merge(Vec3{3, 0, 0});
+		EXPECT_TRUE(IsNearlyEqual(b4.max, Vec3{3, 1, 1}));
+		EXPECT_TRUE(IsNearlyEqual(b4.Size(), Vec3{4, 2, 2}));
+		EXPECT_NEAR(b4.SurfaceArea(), 2 * (8 + 4 + 8), kSmallNum);
+
+		constexpr auto ground = Plane::FromPointNormal({}, UVec3::Up());
+		static_assert(IsOverlapped(b1, ground));
+		static_assert(!IsOverlapped(b2, ground));
+		static_assert(IsOverlapped(Sphere{Vec3{0, 0, -0.5f}, 1}, ground));
+
+		const auto pl = Plane::FromPoints(Vec3{0, 0, 1}, Vec3{1, 0, 1}, Vec3{0, 1, 1});
+		ASSERT_TRUE(pl.has_value());
+		EXPECT_NEAR(pl->Dist(Vec3{5, 5, 3}), 2, kSmallNum);
+		EXPECT_FALSE(Plane::FromPoints(Vec3{}, Vec3{1, 0, 0}, Vec3{2, 0, 0}).has_value());
+
+		constexpr Capsule c1{Vec3{-1, 0, 0}, Vec3{1, 0, 0}, 0.5f};
+		constexpr Capsule c2{Vec3{0, -1, 0.9f}, Vec3{0, 1, 0.9f}, 0.5f};
+		constexpr Capsule c3{Vec3{0, -1, 1.1f}, Vec3{0, 1, 1.1f}, 0.5f};
+		static_assert(IsOverlapped(c1, c2));
+		static_assert(!IsOverlapped(c1, c3));
+		static_assert(IsOverlapped(Sphere{Vec3{1.2f, 0.5f, 0}, 0.3f}, c1));
+		static_assert(!IsOverlapped(Sphere{Vec3{0, 1, 0}, 0.4f}, c1));
+
+		constexpr auto bt = Bounds(Triangle{Vec3{0, 1, 2}, Vec3{-1, 5, 0}, Vec3{3, 0, 1}});
+		EXPECT_TRUE(IsNearlyEqual(bt.min, Vec3{-1, 0, 0}));
+		EXPECT_TRUE(IsNearlyEqual(bt.max, Vec3{3, 5, 2}));
+	}
+
+	TEST(Geometry, OBB)
+	{
+		constexpr Vec3 ext{1, 2, 0.5f};
+		constexpr OBB a{Vec3{}, Mat3::Identity(), ext};
+		EXPECT_TRUE(IsOverlapped(a, OBB{Vec3{1.9f, 0, 0}, Mat3::Identity(), ext}));
+		EXPECT_FALSE(IsOverlapped(a, OBB{Vec3{2.1f, 0, 0}, Mat3::Identity(), ext}));
+
+		// Rotating b by 45 degrees around Z brings its corner closer to a
+		const auto q = Quat{UVec3::Up(), 45_deg};
+		const auto rot_ext = Vec3{1, 1, 1};
+		const auto reach = std::sqrt(2.f);
+		EXPECT_TRUE(IsOverlapped(a, OBB::FromRotation(Vec3{1 + reach - 0.1f, 0, 0}, q, rot_ext)));
+		EXPECT_FALSE(IsOverlapped(a, OBB::FromRotation(Vec3{1 + reach + 0.1f, 0, 0}, q, rot_ext)));
+
+		// Edge along X on top of c crosses edge along Y at bottom of d. Separated only along Z, which is their cross product
+		const auto qx = Quat{*Vec3{1, 0, 0}.Unit(), 45_deg};
+		const auto qy = Quat{*Vec3{0, 1, 0}.Unit(), 45_deg};
+		const auto c = OBB::FromRotation(Vec3{}, qx, Vec3::One());
+		EXPECT_TRUE(IsOverlapped(c, OBB::FromRotation(Vec3{0, 0, 2 * reach - 0.1f}, qy, Vec3::One())));
+		EXPECT_FALSE(IsOverlapped(c, OBB::FromRotation(Vec3{0, 0, 2 * reach + 0.1f}, qy, Vec3::One())));
+
+		const auto bb = Bounds(OBB::FromRotation(Vec3{}, q, rot_ext));
+		EXPECT_TRUE(IsNearlyEqual(bb.max, Vec3{reach, reach, 1}));
+	}
+
+	TEST(Geometry, Raycast)
+	{
+		constexpr AABB box{Vec3{-1, -1, -1}, Vec3{1, 1, 1}};
+		const Ray r1{Vec3{-5, 0, 0}, Vec3{2, 0, 0}};
+		EXPECT_NEAR(Raycast(r1, box).value(), 2, kSmallNum);
+		EXPECT_FALSE(Raycast(r1, box, 1.5f).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 2, 0}, Vec3{1, 0, 0}}, box).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 0, 0}, Vec3{-1, 0, 0}}, box).has_value());
+		EXPECT_NEAR(Raycast(Ray{Vec3{}, Vec3{0, 1, 0}}, box).value(), 0, kSmallNum);
+
+		// Grazing a face while parallel to it, in either direction along the zero axis
+		EXPECT_NEAR(Raycast(Ray{Vec3{-5, 1, 0}, Vec3{1, 0, 0}}, box).value(), 4, kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{-5, -1, 0}, Vec3{1, -0.f, 0}}, box).value(), 4, kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{-5, 1, 1}, Vec3{1, 0, 0}}, box).value(), 4, kSmallNum);
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 1, 0}, Vec3{-1, 0, 0}}, box).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 1, 0}, Vec3{1, 0, 0}}, box, 3).has_value());
+
+		constexpr Triangle tri{Vec3{0, 0, 5}, Vec3{1, 0, 5}, Vec3{0, 1, 5}};
+		constexpr Ray r2{Vec3{0.2f, 0.2f, 0}, Vec3{0, 0, 1}};
+		static_assert(IsNearlyEqual(*Raycast(r2, tri), 5));
+		static_assert(IsNearlyEqual(*Raycast(Ray{Vec3{0.2f, 0.2f, 10}, Vec3{0, 0, -1}}, tri), 5));
+		static_assert(!Raycast(r2, tri, 4).has_value());
+		static_assert(!Raycast(Ray{Vec3{0.6f, 0.6f, 0}, Vec3{0, 0, 1}}, tri).has_value());
+		static_assert(!Raycast(Ray{Vec3{0.2f, 0.2f, 0}, Vec3{1, 0, 0}}, tri).has_value());
+
+		constexpr auto ground = Plane::FromPointNormal({}, UVec3::Up());
+		static_assert(IsNearlyEqual(*Raycast(Ray{Vec3{0, 0, 4}, Vec3{1, 0, -2}}, ground), 2));
+		static_assert(!Raycast(Ray{Vec3{0, 0, 4}, Vec3{1, 0, 2}}, ground).has_value());
+
+		const Sphere s{Vec3{0, 10, 0}, 2};
+		EXPECT_NEAR(Raycast(Ray{Vec3{}, Vec3{0, 1, 0}}, s).value(), 8, kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{0, 10, 0}, Vec3{0, 1, 0}}, s).value(), 0, kSmallNum);
+		EXPECT_FALSE(Raycast(Ray{Vec3{}, Vec3{0, -1, 0}}, s).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{3, 0, 0}, Vec3{0, 1, 0}}, s).has_value());
+
+		const Capsule c{Vec3{0, 0, 0}, Vec3{0, 0, 4}, 1};
+		EXPECT_NEAR(Raycast(Ray{Vec3{-5, 0, 2}, Vec3{1, 0, 0}}, c).value(), 4, kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{0, 0, 10}, Vec3{0, 0, -2}}, c).value(), 2.5f, kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{-5, 0, 4.5f}, Vec3{1, 0, 0}}, c).value(), 5 - std::sqrt(0.75f), kSmallNum);
+		EXPECT_NEAR(Raycast(Ray{Vec3{0, 0.5f, 1}, Vec3{1, 0, 0}}, c).value(), 0, kSmallNum);
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 0, 2}, Vec3{1, 0, 0}}, c, 3).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{-5, 0, 6}, Vec3{1, 0, 0}}, c).has_value());
+		EXPECT_FALSE(Raycast(Ray{Vec3{2, 0, -5}, Vec3{0, 0, 1}}, c).has_value());
+	}
+
+	static Float DistToTriangle(const Triangle& tri, const Vec3& p)
+	{
+		return std::sqrt(DistSqr(tri, p));
+	}
+
+	// Compare against sampling the separation along the motion
+	template <class Target, class Dist>
+	static void ExpectTimeOfImpact(const Target& target, Dist&& dist)
+	{
+		for (auto i = 0; i < 200; ++i)
+		{
+			const Sphere s{Vec3::Rand(-6, 6), Rand<Float>(0.1f, 2)};
+			const auto motion = Vec3::Rand(-10, 10);
+			const auto toi = TimeOfImpact(s, motion, target);
+			const auto end = toi ? *toi : 1;
+
+			for (auto k = 0; k <= 100; ++k)
+			{
+				const auto t = end * k / 100;
+				if (toi && t >= *toi) break;
+				ASSERT_GT(dist(s.pos + motion * t) - s.radius, -1e-3_f) << t << " " << end;
+			}
+
+			if (toi)
+			{
+				ASSERT_GE(*toi, 0);
+				ASSERT_LE(*toi, 1);
+				ASSERT_LT(dist(s.pos + motion * *toi) - s.radius, 1e-3_f);
+			}
+		}
+	}
+
+	TEST(Geometry, TimeOfImpact)
+	{
+		const Sphere sphere{Vec3{1, 0, 0}, 1.5f};
+		ExpectTimeOfImpact(sphere, [&](const Vec3& p) { return p.Dist(sphere.pos) - sphere.radius; });
+
+		const auto plane = Plane::FromPointNormal(Vec3{0, 0, 1}, *Vec3{1, 2, 3}.Unit());
+		ExpectTimeOfImpact(plane, [&](const Vec3& p) { return Abs(plane.Dist(p)); });
+
+		const AABB box{Vec3{-1, -2, -0.5f}, Vec3{2, 1, 0.5f}};
+		ExpectTimeOfImpact(box, [&](const Vec3& p) { return Clamp(p, box.min, box.max).Dist(p); });
+
+		const Triangle tri{Vec3{-3, -2, 0}, Vec3{3, -1, 1}, Vec3{0, 3, -1}};
+		ExpectTimeOfImpact(tri, [&](const Vec3& p) { return DistToTriangle(tri, p); });
+
+		// Thin wall is not tunnelled through
+		EXPECT_NEAR(TimeOfImpact(Sphere{Vec3{-50, 0, 0}, 0.1f}, Vec3{100, 0, 0}, AABB{Vec3{0, -5, -5}, Vec3{0.01f, 5, 5}}).value(),
+			0.499f, kSmallNum);
+
+		// Sphere at the tip of a rotating arm sweeping past a static sphere
+		const Vec3 tip{3, 0, 0};
+		const Sphere target{Vec3{0, 3, 0}, 0.5f};
+		const auto Dist = [&](const Transform& a, const Transform& b)
+		{
+			return a.TransformPoint(tip).Dist(b.TransformPoint(target.pos)) - 1;
+		};
+
+		const Transform a0, a1{Quat{UVec3::Up(), 170_deg}};
+		const auto toi = TimeOfImpact(a0, a1, 3.5f, Transform{}, Transform{}, 0.5f, Dist);
+		ASSERT_TRUE(toi.has_value());
+		EXPECT_TRUE(toi->converged);
+
+		// Arm reaches distance 1 from the target at angle 90 - 2 * asin(1 / 6) degrees
+		const auto expected = (kPi / 2 - 2 * std::asin(1_f / 6)) / (kPi * 170 / 180);
+		EXPECT_NEAR(toi->time, expected, 1e-3_f);
+
+		// Pure translation agrees with the swept sphere test
+		const Transform b0{Vec3{-10, -3, 0}}, b1{Vec3{10, -3, 0}};
+		const auto linear = TimeOfImpact(Transform{}, Transform{}, 3.5f, b0, b1, 0.5f, Dist);
+		const auto swept = TimeOfImpact(Sphere{Vec3{-10, 0, 0}, 0.5f}, Vec3{20, 0, 0}, Sphere{tip, 0.5f});
+		ASSERT_TRUE(linear && swept);
+		EXPECT_NEAR(linear->time, *swept, 1e-3_f);
+
+		// Running out of iterations is not mistaken for an impact
+		const auto early = TimeOfImpact(a0, a1, 3.5f, Transform{}, Transform{}, 0.5f, Dist, 1e-3_f, 2);
+		ASSERT_TRUE(early.has_value());
+		EXPECT_FALSE(early->converged);
+		EXPECT_LT(early->time, toi->time);
+
+		EXPECT_FALSE(TimeOfImpact(a0, a0, 3.5f, b0, b0, 0.5f, Dist).has_value());
+	}
+
+	TEST(Geometry, Frustum)
+	{
+		const auto view = MakeLookAt(Vec3{0, 0, -10}, *Vec3{0, 0, 1}.Unit(), *Vec3{0, 1, 0}.Unit());
+		ASSERT_TRUE(view.has_value());
+		const auto f = Frustum::FromViewProj(*view * MakePerspective(Vec2{16, 9}, 1_f, 100_f, 90_deg));
+
+		EXPECT_NEAR(f.planes[Frustum::kNear].Dist(Vec3{0, 0, -9}), 0, 1e-4_f);
+		EXPECT_NEAR(f.planes[Frustum::kFar].Dist(Vec3{0, 0, 80}), 10, 1e-2_f);
+		EXPECT_NEAR(f.planes[Frustum::kTop].Dist(Vec3{0, 10, 0}), 0, 1e-4_f);
+
+		EXPECT_TRUE(IsOverlapped(f, Sphere{Vec3{}, 1}));
+		EXPECT_FALSE(IsOverlapped(f, Sphere{Vec3{0, 0, -12}, 1}));
+		EXPECT_TRUE(IsOverlapped(f, Sphere{Vec3{0, 0, -12}, 3.5f}));
+		EXPECT_FALSE(IsOverlapped(f, Sphere{Vec3{0, 0, 100}, 5}));
+		EXPECT_FALSE(IsOverlapped(f, Sphere{Vec3{0, 12, 0}, 1}));
+		EXPECT_TRUE(IsOverlapped(f, AABB{Vec3{-1, 9, -1}, Vec3{1, 12, 1}}));
+		EXPECT_FALSE(IsOverlapped(f, AABB{Vec3{-1, 11, -1}, Vec3{1, 12, 1}}));
+
+		for (const size_t n : {0, 5, 64, 1003})
+		{
+			std::vector<Vec4> spheres(n);
+			std::vector<Vec3> mins(n), maxs(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				spheres[i] = {Vec3::Rand(-120, 120), Rand<Float>(0, 10)};
+				mins[i] = Vec3::Rand(-120, 120);
+				maxs[i] = mins[i] + Vec3::Rand(0, 20);
+			}
+
+			std::vector<uint64_t> vs((n + 63) / 64 + 1, ~uint64_t{0}), vb(vs);
+			Cull(f, SoA<Vec4>{spheres.data(), n}, vs.data());
+			Cull(f, SoA<Vec3>{mins.data(), n}, SoA<Vec3>{maxs.data(), n}, vb.data());
+			for (size_t i = 0; i < n; ++i)
+			{
+				ASSERT_EQ((vs[i / 64] >> i % 64) & 1, IsOverlapped(f, Sphere{Vec3{spheres[i]}, spheres[i][3]}));
+				ASSERT_EQ((vb[i / 64] >> i % 64) & 1, IsOverlapped(f, AABB{mins[i], maxs[i]}));
+			}
+			if (n % 64 != 0)
+			{
+				EXPECT_EQ(vs[n / 64] >> n % 64, 0);
+			}
+			EXPECT_EQ(vs.back(), ~uint64_t{0});
+		}
+	}
+
+	static OBB RandOBB()
+	{
+		return OBB::FromRotation(Vec3::Rand(-2, 2), Quat::Rand(), Vec3::Rand(0.2f, 1.5f));
+	}
+
+	TEST(Geometry, Gjk)
+	{
+		const auto r = Gjk(Sphere{Vec3{}, 1}, Sphere{Vec3{5, 0, 0}, 1.5f});
+		EXPECT_FALSE(r.IsOverlapped());
+		EXPECT_NEAR(r.distance, 2.5f, 1e-3_f);
+		EXPECT_TRUE(IsNearlyEqual(r.point_a, Vec3{1, 0, 0}, 1e-2_f));
+		EXPECT_TRUE(IsNearlyEqual(r.point_b, Vec3{3.5f, 0, 0}, 1e-2_f));
+
+		constexpr AABB box{Vec3{All{}, -1}, Vec3{All{}, 1}};
+		EXPECT_NEAR(Gjk(box, AABB{Vec3{2, 3, -5}, Vec3{4, 5, 5}}).distance, std::sqrt(5_f), 1e-4_f);
+		EXPECT_TRUE(Gjk(box, Triangle{Vec3{0, 0, 0.5f}, Vec3{5, 0, 0}, Vec3{0, 5, 0}}).IsOverlapped());
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			const Capsule a{Vec3::Rand(-3, 3), Vec3::Rand(-3, 3), Rand<Float>(0.1f, 1)};
+			const Capsule b{Vec3::Rand(-3, 3), Vec3::Rand(-3, 3), Rand<Float>(0.1f, 1)};
+			const auto expected = std::sqrt(DistSqr(Segment{a.a, a.b}, Segment{b.a, b.b})) - a.radius - b.radius;
+			const auto result = Gjk(a, b);
+			if (expected > 1e-2_f)
+			{
+				EXPECT_NEAR(result.distance, expected, 1e-3_f);
+				EXPECT_NEAR(result.point_a.Dist(result.point_b), expected, 1e-3_f);
+			}
+			else if (expected < -1e-2_f)
+			{
+				EXPECT_TRUE(result.IsOverlapped());
+			}
+		}
+
+		// Nearly touching capsules whose last support point nearly repeated a simplex vertex, which made a degenerate
+		// tetrahedron that seemed to contain the origin
+		const Capsule gaps[][2]{
+			{{Vec3{2.00863075f, -2.94362259f, 2.5367732f}, Vec3{-0.453971386f, 2.10256052f, -2.26565742f}, 0.114044525f},
+			 {Vec3{-1.35811579f, -1.85290623f, -1.79444921f}, Vec3{2.69224358f, 2.5403471f, -0.382768154f}, 0.372549981f}},
+			{{Vec3{1.40494967f, 2.99008846f, -1.58459842f}, Vec3{1.65478563f, 1.98165512f, -0.321296215f}, 0.54631871f},
+			 {Vec3{1.52272081f, 2.36800098f, 0.989139557f}, Vec3{-1.52868128f, -0.54720211f, 1.17354107f}, 0.805756867f}},
+			{{Vec3{0.29236412f, -0.236326694f, 0.0606799126f}, Vec3{-0.156990051f, 1.46851254f, -2.7135601f}, 0.429580957f},
+			 {Vec3{1.44833183f, 0.115654707f, -0.193757534f}, Vec3{1.51515961f, 1.28859806f, -2.53671312f}, 0.769035876f}},
+			{{Vec3{2.39784241f, -1.45692194f, -0.486387253f}, Vec3{-2.71200967f, 1.25427341f, 2.57094908f}, 0.241260827f},
+			 {Vec3{2.80356741f, 1.55879593f, 2.6898036f}, Vec3{-2.47375631f, -2.42460799f, 1.6148262f}, 0.907591224f}},
+			{{Vec3{-0.407196045f, 2.25789309f, -1.58637881f}, Vec3{1.73056889f, -2.32976365f, -0.337972879f}, 0.803837061f},
+			 {Vec3{1.5972681f, 1.29156494f, -0.665491819f}, Vec3{-0.920003891f, -0.50647521f, 1.66959667f}, 0.386460781f}},
+		};
+		for (const auto& [a, b] : gaps)
+		{
+			const auto expected = std::sqrt(DistSqr(Segment{a.a, a.b}, Segment{b.a, b.b})) - a.radius - b.radius;
+			const auto result = Gjk(a, b);
+			EXPECT_FALSE(result.IsOverlapped());
+			EXPECT_NEAR(result.distance, expected, 1e-3_f);
+		}
+
+		// Hull of a cube's corners placed by a transform is the same as the OBB
+		Vec3 corners[8];
+		for (size_t k = 0; k < 8; ++k)
+			corners[k] = Vec3{k & 1 ? 1_f : -1_f, k & 2 ? 1_f : -1_f, k & 4 ? 1_f : -1_f};
+
+		for (auto i = 0; i < 100; ++i)
+		{
+			const auto a = RandOBB(), b = RandOBB();
+			const Transform xf{b.center, Quat{b.axes}, b.extent};
+			const auto hull = Gjk(a, Transformed{ConvexHull{corners, 8}, xf});
+			const auto obb = Gjk(a, b);
+			EXPECT_EQ(hull.IsOverlapped(), obb.IsOverlapped());
+			EXPECT_NEAR(hull.distance, obb.distance, 1e-4_f);
+
+			if (obb.distance > 1e-3_f)
+			{
+				EXPECT_FALSE(IsOverlapped(a, b));
+			}
+		}
+
+		// Warm start from the previous frame converges right away
+		GjkSimplex simplex;
+		auto b = OBB::FromRotation(Vec3{3, 0.5f, 0.2f}, Quat{UVec3::Up(), 30_deg}, Vec3{All{}, 1});
+		const auto cold = Gjk(box, b, &simplex);
+		b.center += Vec3{0.01f, 0.02f, 0};
+		const auto warm = Gjk(box, b, &simplex);
+		EXPECT_NEAR(warm.distance, Gjk(box, b).distance, 1e-5_f);
+		EXPECT_LE(warm.iterations, 1);
+		EXPECT_GT(cold.iterations, warm.iterations);
+	}
+
+	TEST(Geometry, Penetration)
+	{
+		EXPECT_FALSE(Penetration(Sphere{Vec3{}, 1}, Sphere{Vec3{3, 0, 0}, 1}).has_value());
+
+		const auto spheres = Penetration(Sphere{Vec3{}, 1}, Sphere{Vec3{1.5f, 0, 0}, 1});
+		ASSERT_TRUE(spheres.has_value());
+		EXPECT_NEAR(spheres->depth, 0.5f, 2e-2_f);
+		EXPECT_TRUE(IsNearlyEqual(spheres->normal, Vec3{1, 0, 0}, 5e-2_f));
+
+		// Stopping early reports the closest face found so far, which is never deeper than the shapes
+		for (size_t it = 1; it <= 16; ++it)
+		{
+			const auto early = Penetration(Sphere{Vec3{}, 1}, Sphere{Vec3{1.5f, 0, 0}, 1}, nullptr, kSmallNum, it);
+			ASSERT_TRUE(early.has_value());
+			EXPECT_LE(early->depth, 0.5f + 1e-4_f);
+			EXPECT_TRUE(IsNearlyEqual(early->point_a - early->point_b, early->normal * early->depth, 1e-3_f));
+		}
+
+		const auto boxes = Penetration(AABB{Vec3{}, Vec3{All{}, 2}}, AABB{Vec3{1.5f, 0.5f, 0.5f}, Vec3{3.5f, 1.5f, 1.5f}});
+		ASSERT_TRUE(boxes.has_value());
+		EXPECT_NEAR(boxes->depth, 0.5f, 1e-4_f);
+		EXPECT_TRUE(IsNearlyEqual(boxes->normal, Vec3{1, 0, 0}, 1e-4_f));
+		EXPECT_NEAR(boxes->point_a[0], 2, 1e-4_f);
+		EXPECT_NEAR(boxes->point_b[0], 1.5f, 1e-4_f);
+
+		// Touching at a single point still has a contact
+		EXPECT_TRUE(Penetration(AABB{Vec3{}, Vec3{All{}, 1}}, AABB{Vec3{All{}, 1}, Vec3{All{}, 2}}).has_value());
+
+		// Moving the second shape by the penetration vector separates them, and not by much more
+		for (auto i = 0; i < 100; ++i)
+		{
+			const auto a = RandOBB();
+			auto b = RandOBB();
+			const auto contact = Penetration(a, b);
+			if (!contact)
+				continue;
+
+			EXPECT_TRUE(IsNearlyEqual(contact->point_a - contact->point_b, contact->normal * contact->depth, 1e-3_f));
+
+			b.center += contact->normal * (contact->depth + 1e-3_f);
+			EXPECT_FALSE(Gjk(a, b).IsOverlapped());
+			b.center -= contact->normal * 2e-3_f;
+			EXPECT_TRUE(Gjk(a, b).IsOverlapped());
+		}
+	}
+
+	static bool Contains(const Sphere& s, const Vec3& p)
+	{
+		return p.Dist(s.pos) <= s.radius * (1 + 1e-4_f);
+	}
+
+	TEST(Geometry, BoundingVolume)
+	{
+		std::vector<Vec3> points(1000);
+		for (auto& p : points)
+			p = Vec3::Rand(-5, 5) * Vec3{3, 1, 0.5f};
+		const SoA<Vec3> soa{points.data(), points.size()};
+
+		auto expected = AABB::Empty();
+		for (const auto& p : points)
+			expected.Merge(p);
+
+		for (const auto n : {size_t{1}, size_t{13}, points.size()})
+		{
+			const SoA<Vec3> part{points.data(), n};
+			EXPECT_TRUE(IsNearlyEqual(Bounds(part).min, Bounds(points.data(), n).min));
+			EXPECT_TRUE(IsNearlyEqual(Bounds(part).max, Bounds(points.data(), n).max));
+		}
+		EXPECT_TRUE(IsNearlyEqual(Bounds(soa).min, expected.min));
+		EXPECT_TRUE(IsNearlyEqual(Bounds(soa).max, expected.max));
+		EXPECT_FALSE(Bounds(points.data(), 0).IsValid());
+		EXPECT_FALSE(Bounds(SoA<Vec3>{}).IsValid());
+
+		Sphere merged{Vec3{}, 1};
+		merged.Merge(Sphere{Vec3{4, 0, 0}, 2});
+		EXPECT_NEAR(merged.radius, 3.5f, 1e-5_f);
+		EXPECT_TRUE(IsNearlyEqual(merged.pos, Vec3{2.5f, 0, 0}));
+		merged.Merge(Sphere{Vec3{1, 0, 0}, 1});
+		EXPECT_NEAR(merged.radius, 3.5f, 1e-5_f);
+		merged.Merge(Vec3{2.5f, 0, 5.5f});
+		EXPECT_NEAR(merged.radius, 4.5f, 1e-5_f);
+		EXPECT_TRUE(Contains(merged, Vec3{2.5f, 0, 5.5f}));
+		EXPECT_TRUE(Contains(merged, Vec3{2.5f, 0, -3.5f}));
+
+		const auto ritter = BoundingSphere(points.data(), points.size());
+		const auto ritter_soa = BoundingSphere(soa);
+		const auto exact = MinBoundingSphere(points.data(), points.size());
+		EXPECT_NEAR(ritter_soa.radius, ritter.radius, 1e-3_f);
+		for (const auto& p : points)
+		{
+			EXPECT_TRUE(Contains(ritter, p));
+			EXPECT_TRUE(Contains(ritter_soa, p));
+			EXPECT_TRUE(Contains(exact, p));
+		}
+		EXPECT_LE(exact.radius, ritter.radius * (1 + 1e-4_f));
+
+		// Cube corners with points inside
+		std::vector<Vec3> cube;
+		for (auto i = 0; i < 8; ++i)
+			cube.push_back(Vec3{i & 1 ? 1_f : -1_f, i & 2 ? 1_f : -1_f, i & 4 ? 1_f : -1_f} + Vec3{1, 2, 3});
+		for (auto i = 0; i < 100; ++i)
+			cube.push_back(Vec3::Rand(-1, 1) + Vec3{1, 2, 3});
+		const auto cube_sphere = MinBoundingSphere(cube.data(), cube.size());
+		EXPECT_NEAR(cube_sphere.radius, std::sqrt(3_f), 1e-4_f);
+		EXPECT_TRUE(IsNearlyEqual(cube_sphere.pos, Vec3{1, 2, 3}, 1e-4_f));
+		EXPECT_NEAR(MinBoundingSphere(cube.data(), 1).radius, 0, 1e-6_f);
+
+		// Minimum among the spheres through every 2, 3 and 4 of a few points that contain all of them
+		for (auto iter = 0; iter < 20; ++iter)
+		{
+			Vec3 p[7];
+			for (auto& x : p)
+				x = Vec3::Rand(-3, 3);
+
+			const auto ContainsAll = [&](const Sphere& s)
+			{
+				return std::all_of(std::begin(p), std::end(p), [&](const Vec3& x) { return Contains(s, x); });
+			};
+
+			auto best = kInf;
+			for (auto a = 0; a < 7; ++a)
+			{
+				for (auto b = a + 1; b < 7; ++b)
+				{
+					if (const auto s = detail::SphereThrough(p[a], p[b]); ContainsAll(s))
+						best = Min(best, s.radius);
+					for (auto c = b + 1; c < 7; ++c)
+					{
+						if (const auto s = detail::SphereThrough(p[a], p[b], p[c]); ContainsAll(s))
+							best = Min(best, s.radius);
+						for (auto d = c + 1; d < 7; ++d)
+							if (const auto s = detail::SphereThrough(p[a], p[b], p[c], p[d]); ContainsAll(s))
+								best = Min(best, s.radius);
+					}
+				}
+			}
+
+			const auto s = MinBoundingSphere(p, 7);
+			EXPECT_TRUE(ContainsAll(s));
+			EXPECT_NEAR(s.radius, best, 1e-3_f);
+		}
+
+		// Points filling an elongated rotated box
+		const auto box = OBB::FromRotation(Vec3{1, -2, 3}, Quat{*Vec3{1, 2, 3}.Unit(), 0.7_rad}, Vec3{4, 1, 0.25f});
+		std::vector<Vec3> filled;
+		for (auto i = 0; i < 2000; ++i)
+			filled.push_back(box.center + Vec3::Rand(-1, 1) * box.extent * box.axes);
+		for (auto i = 0; i < 8; ++i)
+			filled.push_back(box.center + Vec3{i & 1 ? 1_f : -1_f, i & 2 ? 1_f : -1_f, i & 4 ? 1_f : -1_f} * box.extent * box.axes);
+
+		const auto fit = BoundingOBB(filled.data(), filled.size());
+		EXPECT_TRUE(IsNearlyEqual(fit.axes * fit.axes.Transposed(), Mat3::Identity(), 1e-4_f));
+		EXPECT_NEAR((fit.axes[0] ^ fit.axes[1]) | fit.axes[2], 1, 1e-4_f);
+		// Sampling tilts the principal axes a little, and the box must still reach the corners
+		const auto volume = fit.extent[0] * fit.extent[1] * fit.extent[2];
+		EXPECT_GE(volume, 0.999f);
+		EXPECT_LE(volume, 1.25f);
+		EXPECT_GE(Abs(fit.axes[0] | box.axes[0]), 0.999f);
+		EXPECT_TRUE(IsNearlyEqual(fit.center, box.center, 1e-3_f));
+		for (const auto& p : filled)
+		{
+			const auto d = p - fit.center;
+			for (size_t k = 0; k < 3; ++k)
+				EXPECT_LE(Abs(d | fit.axes[k]), fit.extent[k] + 1e-4_f);
+		}
+	}
+
+	TEST(Geometry, RaycastBatch)
+	{
+		std::vector<Triangle> tris(100);
+		for (auto& t : tris)
+		{
+			const auto c = Vec3::Rand(-5, 5);
+			t = {c + Vec3::Rand(-1, 1), c + Vec3::Rand(-1, 1), c + Vec3::Rand(-1, 1)};
+		}
+		const SoA<Triangle> soa{tris.data(), tris.size()};
+		EXPECT_TRUE(IsNearlyEqual(soa[7].c, tris[7].c));
+
+		// Nearest over all triangles, one at a time
+		const auto Expected = [&](const Ray& ray, size_t count, Float max_t)
+		{
+			std::optional<TriangleHit> hit;
+			for (size_t i = 0; i < count; ++i)
+				if (const auto t = Raycast(ray, tris[i], max_t); t && (!hit || *t < hit->t))
+					hit = TriangleHit{static_cast<uint32_t>(i), *t, 0, 0};
+			return hit;
+		};
+
+		// Rays grazing an edge or ending right at a triangle may go either way depending on rounding
+		const auto IsBorderline = [&](const Ray& ray, size_t count, Float max_t)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto& tri = tris[i];
+				const auto n = tri.Normal();
+				const auto denom = n | ray.dir;
+				if (Abs(denom) <= 1e-2_f * n.Len())
+					return true;
+
+				const auto t = (n | (tri.a - ray.origin)) / denom;
+				const auto p = ray.At(t);
+				const auto area = n.LenSqr();
+				const auto u = (((p - tri.a) ^ (tri.c - tri.a)) | n) / -area;
+				const auto v = (((tri.b - tri.a) ^ (p - tri.a)) | n) / area;
+				const auto margin = Min(Min(u, v), 1 - u - v);
+				if (t >= -1e-3_f && t <= max_t + 1e-3_f && Abs(margin) < 1e-3_f)
+					return true;
+				if (margin >= 0 && (Abs(t) < 1e-3_f || Abs(t - max_t) < 1e-3_f))
+					return true;
+			}
+			return false;
+		};
+
+		const auto Check = [&](const Ray& ray, const std::optional<TriangleHit>& hit, size_t count, Float max_t)
+		{
+			if (IsBorderline(ray, count, max_t))
+				return;
+
+			const auto expected = Expected(ray, count, max_t);
+			ASSERT_EQ(hit.has_value(), expected.has_value());
+			if (!hit)
+				return;
+			EXPECT_EQ(hit->index, expected->index);
+			EXPECT_NEAR(hit->t, expected->t, 1e-3_f);
+
+			const auto& tri = tris[hit->index];
+			const auto p = tri.a * (1 - hit->u - hit->v) + tri.b * hit->u + tri.c * hit->v;
+			EXPECT_TRUE(IsNearlyEqual(p, ray.At(hit->t), 1e-3_f));
+		};
+
+		std::vector<Ray> rays(256);
+		for (auto& r : rays)
+			r = {Vec3::Rand(-8, 8), Vec3::Rand(-1, 1) - Vec3::Rand(-0.1f, 0.1f)};
+		for (size_t i = 0; i < 64; ++i)
+		{
+			const auto& t = tris[i];
+			rays[i].dir = (t.a + t.b + t.c) / 3 - rays[i].origin; // Toward a triangle, to hit more
+		}
+		for (auto& r : rays)
+			r.dir.Normalize();
+
+		size_t hit_count = 0;
+		for (const auto& ray : rays)
+		{
+			const auto hit = Raycast(ray, soa);
+			hit_count += hit.has_value();
+			Check(ray, hit, tris.size(), kInf);
+			Check(ray, Raycast(ray, soa, 0.5f), tris.size(), 0.5f);
+		}
+		EXPECT_GE(hit_count, 64u);
+
+		const SoA<Triangle> odd{tris.data(), 13};
+		for (const auto& ray : rays)
+			Check(ray, Raycast(ray, odd), 13, kInf);
+		EXPECT_FALSE(Raycast(rays[0], SoA<Triangle>{}));
+
+		for (size_t first = 0; first < rays.size(); first += RayPacket::size)
+		{
+			// Partial packets leave the remaining lanes alone
+			const auto count = Min(RayPacket::size, size_t{first % 3 == 0 ? 1u : RayPacket::size});
+			const RayPacket packet{&rays[first], count};
+			PacketHits hits;
+			Raycast(packet, tris.data(), tris.size(), hits);
+			for (size_t lane = 0; lane < count; ++lane)
+				Check(rays[first + lane], hits[lane], tris.size(), kInf);
+			for (size_t lane = count; lane < RayPacket::size; ++lane)
+				EXPECT_FALSE(hits[lane]);
+
+			PacketHits near{2};
+			Raycast(packet, tris.data(), tris.size(), near);
+			for (size_t lane = 0; lane < count; ++lane)
+				Check(rays[first + lane], near[lane], tris.size(), 2);
+		}
+	}
+
+	TEST(Geometry, ClosestPoint)
+	{
+		constexpr Segment seg{Vec3{0, 0, 0}, Vec3{2, 0, 0}};
+		static_assert(ClosestPoint(seg, Vec3{1, 5, 0})[0] == 1);
+		EXPECT_TRUE(IsNearlyEqual(ClosestPoint(seg, Vec3{-3, 1, 0}), seg.a));
+		EXPECT_TRUE(IsNearlyEqual(ClosestPoint(seg, Vec3{5, 1, 1}), seg.b));
+		EXPECT_NEAR(DistSqr(Segment{Vec3{1, 1, 1}, Vec3{1, 1, 1}}, Vec3{1, 1, 3}), 4, 1e-5_f);
+
+		constexpr AABB box{Vec3{-1, -2, -3}, Vec3{1, 2, 3}};
+		EXPECT_TRUE(IsNearlyEqual(ClosestPoint(box, Vec3{5, 0, -9}), Vec3{1, 0, -3}));
+		EXPECT_EQ(DistSqr(box, Vec3{0.5f, 1, 2}), 0);
+
+		const auto [p1, p2] = ClosestPoints(Segment{Vec3{0, 0, 0}, Vec3{2, 0, 0}}, Segment{Vec3{1, -1, 1}, Vec3{1, 1, 1}});
+		EXPECT_TRUE(IsNearlyEqual(p1, Vec3{1, 0, 0}));
+		EXPECT_TRUE(IsNearlyEqual(p2, Vec3{1, 0, 1}));
+		EXPECT_NEAR(DistSqr(seg, Segment{Vec3{3, 1, 0}, Vec3{5, 1, 0}}), 2, 1e-5_f); // Parallel
+
+		// Each closest point is on the shape, and no sampled point of the shape is closer
+		const auto Sample = [](auto&& point_at, const auto& closest, const Vec3& p)
+		{
+			const auto dist_sqr = closest.DistSqr(p);
+			for (auto i = 0; i < 200; ++i)
+				EXPECT_GE(point_at().DistSqr(p), dist_sqr - 1e-4_f);
+		};
+
+		for (auto iter = 0; iter < 50; ++iter)
+		{
+			const auto p = Vec3::Rand(-4, 4);
+
+			const Segment s{Vec3::Rand(-2, 2), Vec3::Rand(-2, 2)};
+			const auto on_segment = ClosestPoint(s, p);
+			EXPECT_NEAR(DistSqr(s, on_segment), 0, 1e-4_f);
+			Sample([&] { return s.a + (s.b - s.a) * Rand<Float>(0, 1); }, on_segment, p);
+
+			const Triangle tri{Vec3::Rand(-2, 2), Vec3::Rand(-2, 2), Vec3::Rand(-2, 2)};
+			const auto on_triangle = ClosestPoint(tri, p);
+			Sample([&]
+			{
+				auto u = Rand<Float>(0, 1), v = Rand<Float>(0, 1);
+				if (u + v > 1)
+					u = 1 - u, v = 1 - v;
+				return tri.a + (tri.b - tri.a) * u + (tri.c - tri.a) * v;
+			}, on_triangle, p);
+			EXPECT_NEAR(DistSqr(tri, on_triangle), 0, 1e-4_f);
+
+			const auto obb = RandOBB();
+			const auto on_obb = ClosestPoint(obb, p);
+			Sample([&] { return obb.center + Vec3::Rand(-1, 1) * obb.extent * obb.axes; }, on_obb, p);
+			const auto local = on_obb - obb.center;
+			for (size_t k = 0; k < 3; ++k)
+				EXPECT_LE(Abs(local | obb.axes[k]), obb.extent[k] + 1e-4_f);
+
+			const Segment s2{Vec3::Rand(-2, 2), Vec3::Rand(-2, 2)};
+			const auto [c1, c2] = ClosestPoints(s, s2);
+			EXPECT_NEAR(DistSqr(s, c1), 0, 1e-4_f);
+			EXPECT_NEAR(DistSqr(s2, c2), 0, 1e-4_f);
+			for (auto i = 0; i < 200; ++i)
+			{
+				const auto x = s.a + (s.b - s.a) * Rand<Float>(0, 1), y = s2.a + (s2.b - s2.a) * Rand<Float>(0, 1);
+				EXPECT_GE(x.DistSqr(y), c1.DistSqr(c2) - 1e-4_f);
+			}
+		}
+
+		// Degenerate triangles fall back to their edges
+		EXPECT_NEAR(DistSqr(Triangle{Vec3{0, 0, 0}, Vec3{1, 0, 0}, Vec3{3, 0, 0}}, Vec3{2, 1, 0}), 1, 1e-5_f);
+		EXPECT_NEAR(DistSqr(Triangle{Vec3{1, 1, 1}, Vec3{1, 1, 1}, Vec3{1, 1, 1}}, Vec3{1, 1, 0}), 1, 1e-5_f);
+
+		// Batched versions against the single ones, with a partial pack at the end
+		std::vector<Segment> segs(37);
+		std::vector<Triangle> tris(37);
+		std::vector<Vec3> mins(37), maxs(37);
+		for (size_t i = 0; i < segs.size(); ++i)
+		{
+			segs[i] = {Vec3::Rand(-3, 3), Vec3::Rand(-3, 3)};
+			tris[i] = {Vec3::Rand(-3, 3), Vec3::Rand(-3, 3), Vec3::Rand(-3, 3)};
+			const auto a = Vec3::Rand(-3, 3), b = Vec3::Rand(-3, 3);
+			mins[i] = Min(a, b);
+			maxs[i] = Max(a, b);
+		}
+		segs[3].b = segs[3].a;
+		tris[5] = {Vec3{0, 0, 0}, Vec3{1, 1, 1}, Vec3{2, 2, 2}};
+		tris[6] = {Vec3{1, 2, 3}, Vec3{1, 2, 3}, Vec3{1, 2, 3}};
+
+		const SoA<Segment> seg_soa{segs.data(), segs.size()};
+		const SoA<Triangle> tri_soa{tris.data(), tris.size()};
+		const SoA<Vec3> min_soa{mins.data(), mins.size()}, max_soa{maxs.data(), maxs.size()};
+		EXPECT_TRUE(IsNearlyEqual(seg_soa[7].b, segs[7].b));
+
+		std::vector<Float> out(segs.size() + 1, -1);
+		for (auto iter = 0; iter < 20; ++iter)
+		{
+			const auto p = Vec3::Rand(-4, 4);
+
+			DistSqr(seg_soa, p, out.data());
+			for (size_t i = 0; i < segs.size(); ++i)
+				EXPECT_NEAR(out[i], DistSqr(segs[i], p), 1e-4_f);
+
+			DistSqr(tri_soa, p, out.data());
+			for (size_t i = 0; i < tris.size(); ++i)
+				EXPECT_NEAR(out[i], DistSqr(tris[i], p), 1e-3_f);
+
+			DistSqr(min_soa, max_soa, p, out.data());
+			for (size_t i = 0; i < mins.size(); ++i)
+				EXPECT_NEAR(out[i], DistSqr(AABB{mins[i], maxs[i]}, p), 1e-4_f);
+
+			EXPECT_EQ(out.back(), -1);
+		}
 	}
 }
@@ -112,5 +112,117 @@ namespace otm
 			const auto im = r * r.Inv().value();
 			ASSERT_TRUE(IsNearlyEqual(im, Matrix<double, 4>::identity));
 		}
+
+		constexpr Matrix<int, 2> m2{1, 2, 3, 5};
+		constexpr Matrix<int, 3> m3{1, 2, 3, 0, 1, 4, 5, 6, 0};
+		constexpr Matrix<int, 5> m5{
+			2, 0, 1, 3, 1,
+			1, 1, 0, 2, 4,
+			0, 3, 1, 1, 2,
+			4, 1, 2, 0, 1,
+			1, 2, 3, 1, 0
+		};
+		static_assert(m2.Det() == -1);
+		static_assert(m3.Det() == 1);
+		static_assert(m5.Det() == -152);
+		EXPECT_NEAR((Matrix<double, 5>{m5}.Det()), -152, 1e-9);
+
+		constexpr auto m3i = Mat3{m3}.Inv();
+		static_assert(m3i.has_value());
+		EXPECT_TRUE(IsNearlyEqual(Mat3{m3} * *m3i, Mat3::identity));
+
+		EXPECT_FALSE(Mat3{}.Inv().has_value());
+		EXPECT_FALSE((Mat4{All{}, 1}.Inv().has_value()));
+		EXPECT_FALSE((Matrix<double, 6>{All{}, 2}.Inv().has_value()));
+	}
+
+	template <size_t L>
+	static double MaxAbs(const Matrix<double, L>& m)
+	{
+		double x = 0;
+		for (auto& v : m) for (auto f : v) x = std::max(x, std::abs(f));
+		return x;
+	}
+
+	template <size_t L>
+	void TestInv()
+	{
+		for (auto i=0; i<100; ++i)
+		{
+			const Matrix<double, L> r{[]{ return Rand(-100., 100.); }};
+			const auto inv = r.Inv();
+			ASSERT_TRUE(inv.has_value());
+
+			// Rounding error grows with the condition number, estimated from the largest elements of r and its inverse.
+			// Det(inv) carries the error of inv itself on top.
+			const auto cond = L * MaxAbs(r) * MaxAbs(*inv);
+			ASSERT_TRUE(IsNearlyEqual(r * *inv, Matrix<double, L>::identity, 1e-14 * cond));
+			ASSERT_NEAR(r.Det() * inv->Det(), 1, 1e-14 * cond * cond);
+		}
+	}
+
+	TEST(MatrixTest, InvSizes)
+	{
+		TestInv<1>();
+		TestInv<2>();
+		TestInv<3>();
+		TestInv<4>();
+		TestInv<5>();
+		TestInv<8>();
+	}
+
+	TEST(MatrixTest, MulVec)
+	{
+		for (auto i=0; i<100; ++i)
+		{
+			const Mat4 a{[]{ return Rand(-10_f, 10_f); }};
+			const Mat4 b{[]{ return Rand(-10_f, 10_f); }};
+			const auto ab = a * b;
+			for (size_t r=0; r<4; ++r)
+				for (size_t c=0; c<4; ++c)
+					ASSERT_NEAR(ab[r][c], a[r] | b.Col(c), 1e-3_f);
+
+			const auto v = Vec4::Rand(-10, 10);
+			ASSERT_TRUE(IsNearlyEqual(v * a, (v.ToRowMatrix() * a)[0], 1e-3_f));
+
+			const Vec3 p{v};
+			ASSERT_TRUE(IsNearlyEqual(TransformPoint(p, a), Vec3{Vec4{p, 1} * a}, 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(TransformDirection(p, a), Vec3{Vec4{p, 0} * a}, 1e-3_f));
+		}
+
+		constexpr Mat3 m{
+			1, 2, 3,
+			4, 5, 6,
+			7, 8, 9
+		};
+		constexpr auto v = Vec3{1, 0, -1} * m;
+		EXPECT_TRUE(IsNearlyEqual(v, Vec3{-6, -6, -6}));
+	}
+
+	TEST(MatrixTest, Batch)
+	{
+		const Mat4 m{[]{ return Rand(-2_f, 2_f); }};
+		const Mat4x3 a{m};
+		for (const size_t n : {size_t{13}, size_t{100'003}})
+		{
+			std::vector<Vec3> in(n), points(n), dirs(n);
+			std::vector<Vec4> in4(n), out4(n);
+			for (size_t i=0; i<n; ++i) in[i] = Vec3::Rand(-10, 10);
+			for (size_t i=0; i<n; ++i) in4[i] = Vec4{in[i], Rand(-1_f, 1_f)};
+
+			TransformPoints(in.data(), points.data(), n, m);
+			TransformDirections(in.data(), dirs.data(), n, a);
+			TransformVectors(in4.data(), out4.data(), n, m);
+			for (size_t i=0; i<n; ++i)
+			{
+				ASSERT_TRUE(IsNearlyEqual(points[i], TransformPoint(in[i], m), 1e-3_f));
+				ASSERT_TRUE(IsNearlyEqual(dirs[i], TransformDirection(in[i], m), 1e-3_f));
+				ASSERT_TRUE(IsNearlyEqual(out4[i], in4[i] * m, 1e-3_f));
+			}
+
+			TransformPoints(in.data(), in.data(), n, a);
+			for (size_t i=0; i<n; ++i)
+				ASSERT_TRUE(IsNearlyEqual(in[i], points[i], 1e-3_f));
+		}
 	}
 }
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <set>
+#include "otm/BVH.hpp"
+#include "otm/HashGrid.hpp"
+#include "otm/SweepAndPrune.hpp"
+
+namespace otm
+{
+	static std::vector<AABB> RandBoxes(size_t n)
+	{
+		std::vector<AABB> boxes(n);
+		for (auto& b : boxes)
+		{
+			b.min = Vec3::Rand(-100, 100);
+			b.max = b.min + Vec3::Rand(0, 5);
+		}
+		return boxes;
+	}
+
+	template <class Shape>
+	static void ExpectSameQuery(const BVH& bvh, const std::vector<AABB>& boxes, const Shape& shape)
+	{
+		std::set<uint32_t> found;
+		bvh.Query(shape, [&](uint32_t i) { EXPECT_TRUE(found.insert(i).second); });
+
+		std::set<uint32_t> expected;
+		for (uint32_t i = 0; i < boxes.size(); ++i)
+			if (IsOverlapped(shape, boxes[i])) expected.insert(i);
+
+		EXPECT_EQ(found, expected);
+	}
+
+	static void ExpectSameRaycast(const BVH& bvh, const std::vector<AABB>& boxes, const Ray& ray)
+	{
+		const auto test = [&](uint32_t i, Float max_t) { return Raycast(ray, boxes[i], max_t); };
+		const auto hit = bvh.Raycast(ray, test);
+
+		std::optional<Float> expected;
+		for (uint32_t i = 0; i < boxes.size(); ++i)
+			if (const auto t = Raycast(ray, boxes[i]); t && (!expected || *t < *expected)) expected = t;
+
+		ASSERT_EQ(hit.has_value(), expected.has_value());
+		if (hit)
+		{
+			EXPECT_NEAR(hit->t, *expected, kSmallNum);
+			EXPECT_NEAR(*Raycast(ray, boxes[hit->index]), *expected, kSmallNum);
+		}
+	}
+
+	TEST(Spatial, BVH)
+	{
+		BVH empty;
+		EXPECT_TRUE(empty.empty());
+		empty.Query(Sphere{Vec3{}, 100}, [](uint32_t) { FAIL(); });
+		EXPECT_FALSE(empty.Raycast(Ray{Vec3{}, Vec3{1, 0, 0}}, [](uint32_t, Float) { return std::optional<Float>{}; }));
+
+		auto boxes = RandBoxes(2000);
+		BVH bvh{boxes.data(), boxes.size()};
+		EXPECT_EQ(bvh.size(), boxes.size());
+
+		const auto& root = bvh.Nodes()[0].bounds;
+		for (const auto& b : boxes)
+			ASSERT_TRUE(root.Contains(b.min) && root.Contains(b.max));
+
+		const auto view = MakeLookAt(Vec3{0, 0, -150}, *Vec3{0, 0, 1}.Unit(), *Vec3{0, 1, 0}.Unit());
+		const auto frustum = Frustum::FromViewProj(*view * MakePerspective(Vec2{16, 9}, 1_f, 150_f, 30_deg));
+
+		for (auto i = 0; i < 20; ++i)
+		{
+			ExpectSameQuery(bvh, boxes, Sphere{Vec3::Rand(-100, 100), Rand<Float>(0, 20)});
+			ExpectSameQuery(bvh, boxes, AABB::FromCenterExtent(Vec3::Rand(-100, 100), Vec3::Rand(0, 20)));
+			ExpectSameRaycast(bvh, boxes, Ray{Vec3::Rand(-150, 150), Vec3::Rand(-1, 1)});
+		}
+		ExpectSameQuery(bvh, boxes, frustum);
+
+		// Move everything, then refit
+		for (auto& b : boxes)
+		{
+			const auto d = Vec3::Rand(-10, 10);
+			b.min += d;
+			b.max += d;
+		}
+		bvh.Refit(boxes.data());
+		for (auto i = 0; i < 20; ++i)
+		{
+			ExpectSameQuery(bvh, boxes, Sphere{Vec3::Rand(-100, 100), Rand<Float>(0, 20)});
+			ExpectSameRaycast(bvh, boxes, Ray{Vec3::Rand(-150, 150), Vec3::Rand(-1, 1)});
+		}
+
+		// Coincident items must not break the build
+		std::vector<Sphere> same(100, Sphere{Vec3{1, 2, 3}, 1});
+		bvh.Build(same.data(), same.size(), 1);
+		size_t cnt = 0;
+		bvh.Query(Sphere{Vec3{1, 2, 3}, 0.5f}, [&](uint32_t) { ++cnt; });
+		EXPECT_EQ(cnt, same.size());
+	}
+
+	static void ExpectSameNeighbours(const HashGrid& grid, const std::vector<Vec3>& points, Float radius)
+	{
+		for (auto i = 0; i < 20; ++i)
+		{
+			const auto center = Vec3::Rand(-25, 25);
+			std::set<uint32_t> found;
+			grid.Query(center, radius, [&](uint32_t k) { EXPECT_TRUE(found.insert(k).second); });
+
+			std::set<uint32_t> expected;
+			for (uint32_t k = 0; k < points.size(); ++k)
+				if (points[k].DistSqr(center) <= radius * radius) expected.insert(k);
+
+			EXPECT_EQ(found, expected);
+		}
+
+		std::set<std::pair<uint32_t, uint32_t>> pairs;
+		grid.QueryPairs(radius, [&](uint32_t a, uint32_t b)
+		{
+			EXPECT_LT(a, b);
+			EXPECT_TRUE(pairs.emplace(a, b).second);
+		});
+
+		std::set<std::pair<uint32_t, uint32_t>> expected;
+		for (uint32_t a = 0; a < points.size(); ++a)
+			for (uint32_t b = a + 1; b < points.size(); ++b)
+				if (points[a].DistSqr(points[b]) <= radius * radius) expected.emplace(a, b);
+
+		EXPECT_EQ(pairs, expected);
+	}
+
+	TEST(Spatial, HashGrid)
+	{
+		static_assert(HashCell(Vec3i{1, 2, 3}) != HashCell(Vec3i{3, 2, 1}));
+		EXPECT_EQ(HashGrid{2}.Cell(Vec3{-0.5f, 0, 3.9f}), (Vec3i{-1, 0, 1}));
+
+		std::vector<Vec3> points(500);
+		for (auto& p : points) p = Vec3::Rand(-20, 20);
+
+		HashGrid grid{2};
+		ExpectSameNeighbours(grid, {}, 2);
+
+		grid.Build(points.data(), points.size());
+		EXPECT_EQ(grid.size(), points.size());
+		for (const auto radius : {0.5f, 2.f, 5.f, 40.f})
+			ExpectSameNeighbours(grid, points, radius);
+
+		// Small steps mostly stay within the cell, large ones relink
+		for (uint32_t i = 0; i < points.size(); ++i)
+		{
+			points[i] += Vec3::Rand(-1, 1) * (i % 2 ? 0.1f : 10.f);
+			grid.Move(i, points[i]);
+			EXPECT_TRUE(IsNearlyEqual(grid.Position(i), points[i]));
+		}
+		ExpectSameNeighbours(grid, points, 2);
+
+		// Growing past the bucket table rehashes
+		for (auto i = 0; i < 1000; ++i)
+		{
+			points.push_back(Vec3::Rand(-20, 20));
+			EXPECT_EQ(grid.Insert(points.back()), points.size() - 1);
+		}
+		ExpectSameNeighbours(grid, points, 2);
+
+		// Cells beyond the range of int32_t and radii spanning billions of cells
+		HashGrid far{1e-3_f};
+		const Vec3 ends[]{Vec3{All{}, -1e18_f}, Vec3{All{}, 1e18_f}};
+		far.Build(ends, 2);
+		EXPECT_GT(far.Cell(ends[1])[0], 0);
+		EXPECT_EQ(far.Cell(ends[0]), -far.Cell(ends[1]));
+		size_t count = 0;
+		far.Query(Vec3{}, 2e18_f, [&](uint32_t) { ++count; });
+		EXPECT_EQ(count, 2);
+
+		count = 0;
+		grid.Query(Vec3{}, 1e7_f, [&](uint32_t) { ++count; });
+		EXPECT_EQ(count, points.size());
+	}
+
+	static void ExpectSamePairs(const SweepAndPrune& sap, const std::vector<AABB>& boxes)
+	{
+		std::set<std::pair<uint32_t, uint32_t>> pairs;
+		for (const auto [a, b] : sap.Pairs())
+		{
+			EXPECT_LT(a, b);
+			EXPECT_TRUE(pairs.emplace(a, b).second);
+		}
+
+		std::set<std::pair<uint32_t, uint32_t>> expected;
+		for (uint32_t a = 0; a < boxes.size(); ++a)
+			for (uint32_t b = a + 1; b < boxes.size(); ++b)
+				if (IsOverlapped(boxes[a], boxes[b])) expected.emplace(a, b);
+
+		EXPECT_EQ(pairs, expected);
+	}
+
+	TEST(Spatial, SweepAndPrune)
+	{
+		SweepAndPrune sap;
+		sap.Update(static_cast<const AABB*>(nullptr), 0);
+		EXPECT_TRUE(sap.Pairs().empty());
+
+		auto boxes = RandBoxes(500);
+		sap.Update(boxes.data(), boxes.size());
+		EXPECT_EQ(sap.size(), boxes.size());
+		ExpectSamePairs(sap, boxes);
+
+		// Coherent motion over several frames
+		for (auto frame = 0; frame < 5; ++frame)
+		{
+			for (auto& b : boxes)
+			{
+				const auto d = Vec3::Rand(-2, 2);
+				b.min += d;
+				b.max += d;
+			}
+			sap.Update(boxes.data(), boxes.size());
+			ExpectSamePairs(sap, boxes);
+		}
+
+		// Touching boxes overlap
+		std::vector<AABB> touching{{Vec3{0}, Vec3{1}}, {Vec3{1, 0, 0}, Vec3{2, 1, 1}}};
+		sap.Update(touching.data(), touching.size());
+		ASSERT_EQ(sap.Pairs().size(), 1);
+		EXPECT_EQ(sap.Pairs()[0].b, 1);
+
+		std::vector<Sphere> spheres(200);
+		for (auto& s : spheres) s = {Vec3::Rand(-20, 20), Rand<Float>(0, 3)};
+		sap.Update(spheres.data(), spheres.size());
+		std::vector<AABB> bounds;
+		for (const auto& s : spheres) bounds.push_back(Bounds(s));
+		ExpectSamePairs(sap, bounds);
+	}
+}
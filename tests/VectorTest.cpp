@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
-#include "otm/Vector.hpp"
+#include "otm/Expr.hpp"
+#include "otm/SoA.hpp"
+#include "otm/Transform.hpp"
 
 namespace otm
 {
@@ -88,4 +90,112 @@ namespace otm
 
 		EXPECT_THROW((void)v3.at(3), std::out_of_range);
 	}
+
+	TEST(VectorTest, RuntimeMatchesConstexpr)
+	{
+		constexpr Vec4 a{1.5f, -2, 3, 0.25f}, b{-4, 0.5f, 2, 8};
+		constexpr auto sum = a + b, diff = a - b, prod = a * b, scaled = a * 3 / 2;
+		constexpr auto dot = a | b;
+		constexpr auto cross = Vec3{a} ^ Vec3{b};
+		constexpr auto lerp = Lerp(a, b, 0.25f);
+
+		auto ra = a, rb = b;
+		EXPECT_TRUE(IsNearlyEqual(ra + rb, sum));
+		EXPECT_TRUE(IsNearlyEqual(ra - rb, diff));
+		EXPECT_TRUE(IsNearlyEqual(ra * rb, prod));
+		EXPECT_TRUE(IsNearlyEqual(ra * 3 / 2, scaled));
+		EXPECT_NEAR(ra | rb, dot, kSmallNum);
+		EXPECT_TRUE(IsNearlyEqual(Vec3{ra} ^ Vec3{rb}, cross));
+		EXPECT_TRUE(IsNearlyEqual(Lerp(ra, rb, 0.25f), lerp));
+
+		ra += rb;
+		EXPECT_TRUE(IsNearlyEqual(ra, sum));
+
+		Vec3 v{3, 4, 12};
+		EXPECT_NEAR(v.LenSqr(), 169, kSmallNum);
+		v.Normalize();
+		EXPECT_TRUE(IsNearlyEqual(v, Vec3{3, 4, 12} / 13));
+	}
+
+	TEST(VectorTest, SoA)
+	{
+		constexpr size_t n = 37;
+		std::vector<Vec3> va(n), vb(n);
+		for (auto& v : va) v = Vec3::Rand(-10, 10);
+		for (auto& v : vb) v = Vec3::Rand(-10, 10);
+		vb[3] = Vec3::Zero();
+
+		SoA<Vec3> a{va.data(), n}, b{va.data(), n};
+		ASSERT_EQ(a.size(), n);
+		for (size_t i=0; i<n; ++i) b.Set(i, vb[i]);
+		for (size_t i=0; i<n; ++i) ASSERT_TRUE(IsNearlyEqual(a[i], va[i]));
+
+		auto sum = a;
+		sum += b;
+		sum *= 2;
+		Float dots[n];
+		Dot(a, b, dots);
+		SoA<Vec3> cross, lerp;
+		Cross(a, b, cross);
+		Lerp(a, b, 0.3_f, lerp);
+		for (size_t i=0; i<n; ++i)
+		{
+			ASSERT_TRUE(IsNearlyEqual(sum[i], (va[i] + vb[i]) * 2, 1e-4_f));
+			ASSERT_NEAR(dots[i], va[i] | vb[i], 1e-3_f);
+			ASSERT_TRUE(IsNearlyEqual(cross[i], va[i] ^ vb[i], 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(lerp[i], Lerp(va[i], vb[i], 0.3_f), 1e-4_f));
+		}
+
+		b.Normalize();
+		for (size_t i=0; i<n; ++i)
+		{
+			if (auto u = vb[i].Unit()) ASSERT_TRUE(IsNearlyEqual(b[i], u->Get()));
+			else ASSERT_TRUE(IsNearlyZero(b[i]));
+		}
+
+		const auto q = Quat::Rand();
+		const Transform t{Vec3::Rand(-10, 10), q, Vec3::Rand(0.5, 2)};
+		auto rotated = a, points = a, dirs = a;
+		rotated.RotateBy(q);
+		points.TransformPoints(t.ToMatrix());
+		dirs.TransformDirections(t.ToAffine());
+		for (size_t i=0; i<n; ++i)
+		{
+			ASSERT_TRUE(IsNearlyEqual(rotated[i], va[i].RotatedBy(q), 1e-4_f));
+			ASSERT_TRUE(IsNearlyEqual(points[i], t.TransformPoint(va[i]), 1e-3_f));
+			ASSERT_TRUE(IsNearlyEqual(dirs[i], t.TransformVector(va[i]), 1e-3_f));
+		}
+
+		SoA<Vec4> v4;
+		for (size_t i=0; i<n; ++i) v4.PushBack(Vec4{va[i], 1});
+		const Mat4 m{[]{ return Rand(-2_f, 2_f); }};
+		v4 *= m;
+		for (size_t i=0; i<n; ++i)
+			ASSERT_TRUE(IsNearlyEqual(v4[i], Vec4{va[i], 1} * m, 1e-3_f));
+	}
+
+	TEST(VectorTest, Expr)
+	{
+		constexpr Vector<float, 8> a{1, 2, 3, 4, 5, 6, 7, 8};
+		constexpr Vector<float, 8> b{All{}, 2};
+		constexpr Vector<float, 8> c{8, 7, 6, 5, 4, 3, 2, 1};
+
+		constexpr Vector<float, 8> r = Lazy(a) * 3 + Lazy(b) * Lazy(c) - Lazy(c) / 2;
+		static_assert(IsNearlyEqual(r, a * 3 + b * c - c / 2));
+		EXPECT_TRUE(IsNearlyEqual(Vector<float, 8>{Lazy(c) - Lazy(a) * Lazy(b)}, c - a * b));
+		EXPECT_TRUE(IsNearlyEqual(Eval(-Lazy(a) + Lazy(b)), b - a));
+
+		constexpr Mat3 m{
+			1, 2, 3,
+			4, 5, 6,
+			7, 8, 9
+		};
+		constexpr Mat3 n = Lazy(m) * 2 - Lazy(Mat3::Identity());
+		static_assert(IsNearlyEqual(n, m * 2 - Mat3::Identity()));
+
+		// Same number of elements isn't enough
+		static_assert(!detail::kSameShape<RefExpr<Mat4>, RefExpr<Vector<Float, 16>>>);
+		static_assert(!detail::kSameShape<RefExpr<Matrix<Float, 2, 3>>, RefExpr<Matrix<Float, 3, 2>>>);
+		static_assert(detail::kSameShape<RefExpr<Vector<float, 8>>, RefExpr<Vector<double, 8>>>);
+	}
 }